@@ -2,10 +2,16 @@
  * @brief 01字典树（Binary Trie）
  * @details 基于二进制位的字典树，支持插入、删除、计数、最大最小值查询、枚举等操作
  *          适用于处理整数的位运算相关问题，如异或最大值、异或第k小等
- * @complexity 插入/删除/查询: O(log U), 其中U为值域大小
+ *          节点以32位下标存储孩子，计数单独成数组，删除后脱离的节点进入空闲链表复用
+ *          bulk_insert对有序序列只走相邻键的分叉部分，整体线性建树
+ *          apply_xor为全体键打上异或懒标记，实际存储的是键异或标记后的值，所有操作在遍历时按标记翻转
+ * @complexity 插入/删除/查询/第k小异或: O(log U), 其中U为值域大小; 全体异或: O(1); 有序批量插入: O(节点数)
  */
 #pragma once
+#include <bit>
 #include <array>
+#include <limits>
+#include <ranges>
 #include <vector>
 #include <cstdint>
 #include <utility>
@@ -13,19 +19,24 @@
 template <std::unsigned_integral Key, typename T = std::size_t, std::size_t width = std::numeric_limits<Key>::digits>
 class BinaryTrie {
 private:
-    using node = std::pair<T, std::array<std::size_t, 2>>;
-    static constexpr auto root = std::size_t(0);
-    static constexpr auto invalid = std::size_t(-1);
-    static constexpr auto children = std::array<std::size_t, 2>{invalid, invalid};
+    using index_type = std::uint32_t;
+    static constexpr auto root = index_type(0);
+    static constexpr auto invalid = index_type(-1);
+    static constexpr auto children = std::array<index_type, 2>{invalid, invalid};
+    // 只有低width位参与建树, 与insert逐位读取时忽略高位的行为一致
+    static constexpr auto low_bits = width >= std::numeric_limits<Key>::digits ? Key(-1) : Key((Key(1) << width) - 1);
 
 public:
-    BinaryTrie() : _size() {
+    BinaryTrie() : _size(), mask() {
         allocate_node();
     }
 
     void clear() {
         _size = 0;
-        trie.clear();
+        mask = 0;
+        next.clear();
+        number.clear();
+        recycle.clear();
         allocate_node();
     }
 
@@ -37,93 +48,159 @@ public:
         return _size == 0;
     }
 
+    void reserve(std::size_t nodes) {
+        next.reserve(nodes);
+        number.reserve(nodes);
+    }
+
     void insert(Key key, T count = 1) {
         if (count <= 0) {
             return;
         }
-        std::size_t index = root;
-        trie.at(root).first += count;
+        key ^= mask;
+        index_type index = root;
+        number[root] += count;
         for (std::size_t i = width - 1; i + 1 != 0; --i) {
             Key bit = key >> i & 1;
-            if (trie.at(index).second.at(bit) == invalid) {
-                allocate_node();
-                trie.at(index).second.at(bit) = trie.size() - 1;
+            if (next[index][bit] == invalid) {
+                auto child = allocate_node();
+                next[index][bit] = child;
             }
-            trie.at(index = trie.at(index).second.at(bit)).first += count;
+            number[index = next[index][bit]] += count;
         }
         _size += count;
     }
 
-    bool erase(Key key, T count = 1) {
-        if (count <= 0 or trie.at(root).first < count) {
-            return false;
+    // 相邻两键只需处理最长公共前缀以下的部分, 公共前缀上的计数延迟到该节点离开路径时再一次性写回
+    void bulk_insert(const std::ranges::range auto &keys, T count = 1) {
+        if (count <= 0) {
+            return;
         }
-        auto impl = [&](auto &&self, std::size_t index, std::size_t depth) -> bool {
-            if (depth == width) {
-                if (trie.at(index).first < count) {
-                    return false;
-                }
-                trie.at(index).first -= count;
-                return true;
+        std::array<index_type, width + 1> path;
+        std::array<T, width + 1> pending{};
+        std::size_t depth = 0;
+        Key last = 0;
+        path[0] = root;
+        for (Key key : keys) {
+            key = (key ^ mask) & low_bits;
+            std::size_t common = depth == 0 ? 0 : width - std::bit_width(static_cast<Key>(last ^ key));
+            for (; depth > common; --depth) {
+                number[path[depth]] += pending[depth];
+                pending[depth - 1] += std::exchange(pending[depth], T{});
             }
-            Key bit = key >> (width - depth - 1) & 1;
-            auto &child = trie.at(index).second.at(bit);
-            if (child == invalid or trie.at(child).first < count) {
-                return false;
+            for (; depth < width; ++depth) {
+                Key bit = key >> (width - depth - 1) & 1;
+                if (next[path[depth]][bit] == invalid) {
+                    auto child = allocate_node();
+                    next[path[depth]][bit] = child;
+                }
+                path[depth + 1] = next[path[depth]][bit];
             }
-            if (not self(self, child, depth + 1)) {
+            pending[width] += count;
+            _size += count;
+            last = key;
+        }
+        for (; depth > 0; --depth) {
+            number[path[depth]] += pending[depth];
+            pending[depth - 1] += pending[depth];
+        }
+        number[root] += pending[0];
+    }
+
+    bool erase(Key key, T count = 1) {
+        if (count <= 0 or number[root] < count) {
+            return false;
+        }
+        key ^= mask;
+        std::array<index_type, width + 1> path;
+        path[0] = root;
+        for (std::size_t depth = 0; depth < width; ++depth) {
+            auto child = next[path[depth]][key >> (width - depth - 1) & 1];
+            if (child == invalid or number[child] < count) {
                 return false;
             }
-            if (trie.at(index).first -= count; trie.at(child).first == 0) {
-                child = invalid;
+            path[depth + 1] = child;
+        }
+        for (std::size_t depth = 0; depth <= width; ++depth) {
+            number[path[depth]] -= count;
+        }
+        for (std::size_t depth = 1; depth <= width; ++depth) {
+            if (number[path[depth]] == 0) {
+                next[path[depth - 1]][key >> (width - depth) & 1] = invalid;
+                recycle.insert(recycle.end(), path.begin() + depth, path.end());
+                break;
             }
-            return true;
-        };
-        bool success = impl(impl, root, 0);
-        if (success) {
-            _size -= count;
         }
-        return success;
+        _size -= count;
+        return true;
     }
 
     T count(Key key) const {
-        std::size_t index = root;
+        key ^= mask;
+        index_type index = root;
         for (std::size_t i = width - 1; i + 1 != 0; --i) {
             Key bit = key >> i & 1;
-            auto &child = trie.at(index).second.at(bit);
+            auto child = next[index][bit];
             if (child == invalid) {
                 return 0;
             }
             index = child;
         }
-        return trie.at(index).first;
+        return number[index];
+    }
+
+    void apply_xor(Key value) {
+        mask ^= value;
     }
 
     std::pair<Key, T> limit_xor(Key key, bool max) const {
+        key ^= mask;
         Key res = 0;
-        std::size_t index = root;
+        index_type index = root;
         for (std::size_t i = width - 1; i + 1 != 0; --i) {
             Key bit = (key >> i & 1) ^ max;
-            auto &left_child = trie.at(index).second.at(bit);
-            bit ^= not (left_child != invalid and trie.at(left_child).first > 0);
-            if (auto &right_child = trie.at(index).second.at(bit); right_child != invalid and trie.at(right_child).first > 0) {
+            auto left_child = next[index][bit];
+            bit ^= not (left_child != invalid and number[left_child] > 0);
+            if (auto right_child = next[index][bit]; right_child != invalid and number[right_child] > 0) {
                 res |= bit << i;
                 index = right_child;
             } else {
                 return {0, 0};
             }
         }
-        return {res ^= key, trie.at(index).first};
+        return {res ^= key, number[index]};
+    }
+
+    // 所有键与key异或后的第k小值(0-indexed, 重复计数)及其出现次数
+    std::pair<Key, T> kth_xor(Key key, T k) const {
+        if (k < 0 or k >= number[root]) {
+            return {0, 0};
+        }
+        key ^= mask;
+        Key res = 0;
+        index_type index = root;
+        for (std::size_t i = width - 1; i + 1 != 0; --i) {
+            Key bit = key >> i & 1;
+            auto child = next[index][bit];
+            T smaller = child != invalid ? number[child] : T{};
+            if (k >= smaller) {
+                k -= smaller;
+                bit ^= 1;
+                res |= Key(1) << i;
+            }
+            index = next[index][bit];
+        }
+        return {res, number[index]};
     }
 
     void enumerate(auto &&call) const {
-        const auto impl = [&call, this](auto &&self, std::size_t index, Key prefix, std::size_t depth) -> void {
+        const auto impl = [&call, this](auto &&self, index_type index, Key prefix, std::size_t depth) -> void {
             if (depth == width) {
-                std::forward<decltype(call)>(call)(prefix, trie.at(index).first);
+                std::forward<decltype(call)>(call)(prefix, number[index]);
                 return;
             }
             for (std::size_t bit = 0; bit < 2; ++bit) {
-                if (auto &child = trie.at(index).second.at(bit); child != invalid and trie.at(child).first > 0) {
+                if (auto child = next[index][bit ^ (mask >> (width - depth - 1) & 1)]; child != invalid and number[child] > 0) {
                     self(self, child, prefix | (static_cast<Key>(bit) << (width - depth - 1)), depth + 1);
                 }
             }
@@ -146,8 +223,20 @@ public:
 
 private:
     T _size;
-    std::vector<node> trie;
-    void allocate_node() {
-        trie.emplace_back(T{}, children);
+    Key mask;
+    std::vector<std::array<index_type, 2>> next;
+    std::vector<T> number;
+    std::vector<index_type> recycle;
+    index_type allocate_node() {
+        if (not recycle.empty()) {
+            auto index = recycle.back();
+            recycle.pop_back();
+            next[index] = children;
+            number[index] = T{};
+            return index;
+        }
+        next.push_back(children);
+        number.push_back(T{});
+        return next.size() - 1;
     }
 };
\ No newline at end of file
@@ -0,0 +1,204 @@
+/**
+ * @brief 路径压缩01字典树（Compressed Binary Trie / PATRICIA）
+ * @details 接口与BinaryTrie一致，支持插入、删除、计数、异或最值查询、枚举等操作
+ *          单孩子链被压缩为一条边，每个节点记录已确定的前缀长度，除根外的内部节点恰有两个孩子
+ *          n个不同的键最多使用2n个节点，适用于值域很大但键稀疏的场景（如width=64的稀疏id）
+ * @complexity 插入/删除/查询: O(min(log U, n)), 其中U为值域大小，实际深度为路径上的分叉数
+ */
+#pragma once
+#include <bit>
+#include <array>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+template <std::unsigned_integral Key, typename T = std::size_t, std::size_t width = std::numeric_limits<Key>::digits>
+class CompressedBinaryTrie {
+private:
+    using index_type = std::uint32_t;
+    static constexpr auto root = index_type(0);
+    static constexpr auto invalid = index_type(-1);
+    static constexpr auto children = std::array<index_type, 2>{invalid, invalid};
+    // 只有低width位参与建树, 与BinaryTrie一致; 高位不清除时common_length会下溢
+    static constexpr auto low_bits = width >= std::numeric_limits<Key>::digits ? Key(-1) : Key((Key(1) << width) - 1);
+
+public:
+    CompressedBinaryTrie() : _size() {
+        allocate_node(0, 0);
+    }
+
+    void clear() {
+        _size = 0;
+        next.clear();
+        number.clear();
+        prefix.clear();
+        length.clear();
+        recycle.clear();
+        allocate_node(0, 0);
+    }
+
+    T size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    void insert(Key key, T count = 1) {
+        if (count <= 0) {
+            return;
+        }
+        key &= low_bits;
+        _size += count;
+        number[root] += count;
+        for (index_type index = root;;) {
+            auto bit = bit_at(key, length[index]);
+            auto child = next[index][bit];
+            if (child == invalid) {
+                auto leaf = allocate_node(key, width);
+                number[leaf] = count;
+                next[index][bit] = leaf;
+                return;
+            }
+            if (auto common = common_length(key, prefix[child]); common < length[child]) {
+                auto leaf = allocate_node(key, width);
+                auto middle = allocate_node(key, common);
+                number[leaf] = count;
+                number[middle] = number[child] + count;
+                next[middle][bit_at(key, common)] = leaf;
+                next[middle][bit_at(prefix[child], common)] = child;
+                next[index][bit] = middle;
+                return;
+            }
+            number[child] += count;
+            if (length[child] == width) {
+                return;
+            }
+            index = child;
+        }
+    }
+
+    bool erase(Key key, T count = 1) {
+        if (count <= 0 or number[root] < count) {
+            return false;
+        }
+        key &= low_bits;
+        std::array<index_type, width + 1> path;
+        std::size_t depth = 0;
+        path[0] = root;
+        while (length[path[depth]] != width) {
+            auto child = next[path[depth]][bit_at(key, length[path[depth]])];
+            if (child == invalid or number[child] < count or common_length(key, prefix[child]) < length[child]) {
+                return false;
+            }
+            path[++depth] = child;
+        }
+        for (std::size_t i = 0; i <= depth; ++i) {
+            number[path[i]] -= count;
+        }
+        _size -= count;
+        if (number[path[depth]] != 0) {
+            return true;
+        }
+        auto parent = path[depth - 1];
+        next[parent][bit_at(key, length[parent])] = invalid;
+        recycle.push_back(path[depth]);
+        if (parent != root) {
+            auto grand = path[depth - 2];
+            auto sibling = next[parent][0] == invalid ? next[parent][1] : next[parent][0];
+            next[grand][bit_at(key, length[grand])] = sibling;
+            recycle.push_back(parent);
+        }
+        return true;
+    }
+
+    T count(Key key) const {
+        key &= low_bits;
+        index_type index = root;
+        while (length[index] != width) {
+            index = next[index][bit_at(key, length[index])];
+            if (index == invalid or common_length(key, prefix[index]) < length[index]) {
+                return 0;
+            }
+        }
+        return number[index];
+    }
+
+    std::pair<Key, T> limit_xor(Key key, bool max) const {
+        if (number[root] == 0) {
+            return {0, 0};
+        }
+        key &= low_bits;
+        index_type index = root;
+        while (length[index] != width) {
+            auto bit = bit_at(key, length[index]) ^ max;
+            auto child = next[index][bit];
+            index = child != invalid ? child : next[index][bit ^ 1];
+        }
+        return {prefix[index] ^ key, number[index]};
+    }
+
+    void enumerate(auto &&call) const {
+        const auto impl = [&call, this](auto &&self, index_type index) -> void {
+            if (length[index] == width) {
+                std::forward<decltype(call)>(call)(prefix[index], number[index]);
+                return;
+            }
+            for (std::size_t bit = 0; bit < 2; ++bit) {
+                if (auto child = next[index][bit]; child != invalid) {
+                    self(self, child);
+                }
+            }
+        };
+        if (number[root] != 0) {
+            impl(impl, root);
+        }
+    }
+
+    template <typename Ostream>
+    friend Ostream &operator<<(Ostream &ostream, const CompressedBinaryTrie &self) {
+        ostream << '{';
+        bool first = true;
+        self.enumerate([&](Key key, T count) -> void {
+            if (not std::exchange(first, false)) {
+                ostream << ", ";
+            }
+            ostream << key << '*' << count;
+        });
+        return ostream << '}';
+    }
+
+private:
+    T _size;
+    std::vector<std::array<index_type, 2>> next;
+    std::vector<T> number;
+    std::vector<Key> prefix;
+    std::vector<index_type> length;
+    std::vector<index_type> recycle;
+    static constexpr std::size_t bit_at(Key key, std::size_t depth) {
+        return key >> (width - depth - 1) & 1;
+    }
+
+    static constexpr std::size_t common_length(Key x, Key y) {
+        return width - std::bit_width(static_cast<Key>(x ^ y));
+    }
+
+    index_type allocate_node(Key key, std::size_t depth) {
+        if (not recycle.empty()) {
+            auto index = recycle.back();
+            recycle.pop_back();
+            next[index] = children;
+            number[index] = T{};
+            prefix[index] = key;
+            length[index] = depth;
+            return index;
+        }
+        next.push_back(children);
+        number.push_back(T{});
+        prefix.push_back(key);
+        length.push_back(depth);
+        return next.size() - 1;
+    }
+};
\ No newline at end of file
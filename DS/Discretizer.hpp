@@ -2,15 +2,29 @@
  * @brief 离散化工具类
  * @details 将连续的值域映射到较小的离散区间，常用于坐标压缩
  *          支持查询原值对应的离散化位置和离散化位置对应的原值
- * @complexity 预处理: O(n log n), 查询: O(log n)
+ *          整数类型在数据量较大时使用按字节的LSD基数排序，rank_all将询问排序后与字典归并扫描，替代逐个二分
+ *          online = true时prepare后改用有序分块存储，块大小超过上限时分裂，块内元素个数用树状数组维护，支持在线插入
+ * @complexity 预处理: O(n log n), 整数: O(n * sizeof(T)); 查询: O(log n); 批量查询: O(q log q + n), 整数: O(q * sizeof(T) + n)
+ *             在线插入: 均摊O(log n + B), 在线查询/按排名取值: O(log n), 其中B为块大小
  */
 #pragma once
+#include "BinaryIndexedTree.hpp"
+#include <span>
+#include <array>
+#include <limits>
 #include <vector>
+#include <numeric>
 #include <algorithm>
-template <typename T>
+#include <type_traits>
+template <typename T, bool online = false>
 class Discretizer {
+private:
+    static constexpr bool radix = std::integral<T> and not std::same_as<T, bool>;
+    static constexpr std::size_t radix_threshold = 1 << 8;
+    static constexpr std::size_t block_size = 1 << 9;
+
 public:
-    Discretizer() : _prepared{}, discretizer{} {}
+    Discretizer() : _prepared{}, _size{}, discretizer{} {}
 
     Discretizer(std::ranges::range auto container) : Discretizer() {
         discretizer.reserve(container.size());
@@ -35,6 +49,10 @@ public:
             discretizer.push_back(value);
             return;
         }
+        if constexpr (online) {
+            insert(value);
+            return;
+        }
         auto it = std::lower_bound(discretizer.begin(), discretizer.end(), value);
         if (it == discretizer.end()) {
             discretizer.push_back(value);
@@ -46,21 +64,114 @@ public:
     }
 
     std::size_t size() const {
+        if constexpr (online) {
+            if (_prepared) {
+                return _size;
+            }
+        }
         return discretizer.size();
     }
 
     void prepare() {
+        if constexpr (online) {
+            if (_prepared) {
+                return;
+            }
+        }
         _prepared = true;
-        std::sort(discretizer.begin(), discretizer.end());
+        if constexpr (radix) {
+            if (discretizer.size() >= radix_threshold) {
+                radix_sort(discretizer, std::identity{});
+            } else {
+                std::sort(discretizer.begin(), discretizer.end());
+            }
+        } else {
+            std::sort(discretizer.begin(), discretizer.end());
+        }
         discretizer.resize(std::unique(discretizer.begin(), discretizer.end()) - discretizer.begin());
+        if constexpr (online) {
+            _size = discretizer.size();
+            for (std::size_t i = 0; i < discretizer.size(); i += block_size) {
+                blocks.emplace_back(discretizer.begin() + i, discretizer.begin() + std::min(i + block_size, discretizer.size()));
+                heads.push_back(discretizer[i]);
+            }
+            std::vector<T>().swap(discretizer);
+            rebuild();
+        }
     }
 
     std::size_t rank(const T &value) const {
+        if constexpr (online) {
+            if (_prepared) {
+                if (blocks.empty()) {
+                    return 0;
+                }
+                auto block = locate(value);
+                return before(block) + std::distance(blocks[block].begin(), std::lower_bound(blocks[block].begin(), blocks[block].end(), value));
+            }
+        }
         return std::distance(discretizer.begin(), std::lower_bound(discretizer.begin(), discretizer.end(), value));
     }
 
+    const T &operator[](std::size_t index) const {
+        if constexpr (online) {
+            if (_prepared) {
+                auto block = count.kth(index);
+                return blocks[block][index - before(block)];
+            }
+        }
+        return discretizer[index];
+    }
+
+    std::vector<std::size_t> rank_all(std::span<const T> values) const {
+        std::vector<std::pair<T, std::size_t>> queries(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            queries[i] = {values[i], i};
+        }
+        if constexpr (radix) {
+            radix_sort(queries, [](const auto &query) {
+                return query.first;
+            });
+        } else {
+            std::sort(queries.begin(), queries.end());
+        }
+        std::vector<std::size_t> res(values.size());
+        std::size_t j = 0;
+        if constexpr (online) {
+            if (_prepared) {
+                std::size_t block = 0, offset = 0;
+                for (const auto &[value, index] : queries) {
+                    while (block < blocks.size() and blocks[block][offset] < value) {
+                        ++j;
+                        if (++offset == blocks[block].size()) {
+                            ++block;
+                            offset = 0;
+                        }
+                    }
+                    res[index] = j;
+                }
+                return res;
+            }
+        }
+        for (const auto &[value, index] : queries) {
+            while (j < discretizer.size() and discretizer[j] < value) {
+                ++j;
+            }
+            res[index] = j;
+        }
+        return res;
+    }
+
     template <typename Ostream>
     friend Ostream &operator<<(Ostream &ostream, const Discretizer &self) {
+        if constexpr (online) {
+            if (self._prepared) {
+                for (std::size_t i = 0; i < self.size(); ++i) {
+                    ostream << (i == 0 ? "" : " ") << self[i];
+                }
+                return ostream;
+            }
+        }
         auto it = self.discretizer.begin();
         for (ostream << *it++; it != self.discretizer.end(); ++it) {
             ostream << ' ' << *it;
@@ -70,5 +181,85 @@ public:
 
 private:
     bool _prepared;
+    std::size_t _size;
     std::vector<T> discretizer;
+    std::vector<T> heads;
+    std::vector<std::vector<T>> blocks;
+    BinaryIndexedTree<std::size_t> count;
+    // 最后一个首元素不超过value的块, value比所有元素都小时为0号块
+    std::size_t locate(const T &value) const {
+        auto it = std::upper_bound(heads.begin(), heads.end(), value);
+        return it == heads.begin() ? 0 : it - heads.begin() - 1;
+    }
+
+    std::size_t before(std::size_t block) const {
+        return block == 0 ? 0 : count.query(0, block - 1);
+    }
+
+    void rebuild() {
+        count = BinaryIndexedTree<std::size_t>(blocks.size(), [&](std::size_t i) {
+            return blocks[i].size();
+        });
+    }
+
+    void insert(const T &value) {
+        if (blocks.empty()) {
+            blocks.push_back({value});
+            heads.push_back(value);
+            ++_size;
+            rebuild();
+            return;
+        }
+        auto block = locate(value);
+        auto &data = blocks[block];
+        auto it = std::lower_bound(data.begin(), data.end(), value);
+        if (it != data.end() and *it == value) {
+            return;
+        }
+        data.insert(it, value);
+        heads[block] = data.front();
+        ++_size;
+        if (data.size() <= 2 * block_size) {
+            count.add(block, 1);
+            return;
+        }
+        std::vector<T> half(data.begin() + block_size, data.end());
+        data.resize(block_size);
+        heads.insert(heads.begin() + block + 1, half.front());
+        blocks.insert(blocks.begin() + block + 1, std::move(half));
+        rebuild();
+    }
+    // 按字节的LSD基数排序, 有符号类型翻转最高位, 所有元素在某一字节上相同时跳过该趟
+    template <typename U>
+    static void radix_sort(std::vector<U> &data, auto &&key) {
+        using unsigned_type = std::make_unsigned_t<T>;
+        constexpr std::size_t passes = sizeof(T);
+        auto digit = [&](const U &value, std::size_t pass) -> std::size_t {
+            auto x = static_cast<unsigned_type>(key(value));
+            if constexpr (std::is_signed_v<T>) {
+                x ^= unsigned_type(1) << (std::numeric_limits<unsigned_type>::digits - 1);
+            }
+            return x >> (pass * 8) & 0xff;
+        };
+        if (data.empty()) {
+            return;
+        }
+        std::array<std::array<std::size_t, 256>, passes> count{};
+        for (const auto &value : data) {
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                ++count[pass][digit(value, pass)];
+            }
+        }
+        std::vector<U> buffer(data.size());
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            if (count[pass][digit(data[0], pass)] == data.size()) {
+                continue;
+            }
+            std::exclusive_scan(count[pass].begin(), count[pass].end(), count[pass].begin(), std::size_t(0));
+            for (const auto &value : data) {
+                buffer[count[pass][digit(value, pass)]++] = value;
+            }
+            data.swap(buffer);
+        }
+    }
 };
\ No newline at end of file
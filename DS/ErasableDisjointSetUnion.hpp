@@ -2,7 +2,8 @@
  * @brief 可撤销并查集（Erasable Disjoint Set Union）
  * @details 支持从集合中移除单个元素的并查集，extract操作将指定点从其所在集合中移除
  *          适用于需要动态删除元素的场景
- * @complexity 合并/查询: O(α(n)), 移除: O(α(n))
+ *          移除产生的虚拟节点通过空闲链表回收，槽位用尽时统一压缩路径并回收_size为0的死节点，空间始终为O(n)
+ * @complexity 合并/查询: O(α(n)), 移除: 均摊O(α(n)), 空间: O(n)
  */
 #pragma once
 #include <vector>
@@ -36,12 +37,12 @@ public:
         if (_size[head] == 1) {
             return head;
         }
-        parent[value] = parent.size();
-        parent.push_back(parent.size());
+        auto slot = allocate();
+        parent[value] = max + slot;
         --_size[head];
-        _size.push_back(1);
+        _size[slot] = 1;
         ++group;
-        return parent[value] - max;
+        return slot;
     }
 
     bool same(std::size_t x, std::size_t y) {
@@ -64,4 +65,31 @@ private:
     std::size_t group;
     std::vector<std::size_t> parent;
     std::vector<std::size_t> _size;
+    std::vector<std::size_t> recycle;
+    std::size_t allocate() {
+        if (recycle.empty()) {
+            if (_size.size() < 2 * max) {
+                parent.push_back(parent.size());
+                _size.push_back(0);
+                return _size.size() - 1;
+            }
+            compact();
+        }
+        auto slot = recycle.back();
+        recycle.pop_back();
+        parent[max + slot] = max + slot;
+        return slot;
+    }
+
+    // 所有元素直接指向根后, _size为0的虚拟节点不再被引用, 可以回收
+    void compact() {
+        for (std::size_t i = 0; i < max; ++i) {
+            parent[i] = max + find(i);
+        }
+        for (std::size_t slot = 0; slot < _size.size(); ++slot) {
+            if (_size[slot] == 0) {
+                recycle.push_back(slot);
+            }
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+/**
+ * @brief 可持久化01字典树（Persistent Binary Trie）
+ * @details 每次插入只新建一条根到叶的路径，其余部分与旧版本共享，所有节点分配在连续数组中
+ *          版本0为空树，insert(version, key)返回新版本号；按顺序插入a[0..n)后版本i对应前缀a[0..i)
+ *          区间[l, r]上的异或最值使用limit_xor(l, r + 1, x, max)，以两个版本的计数差判断子树是否非空
+ *          使用示例：PersistentBinaryTrie<u32> trie; for (auto x : a) trie.insert(trie.versions() - 1, x); trie.limit_xor(l, r + 1, x, true);
+ * @complexity 插入/查询: O(log U), 其中U为值域大小; 空间: O(n log U)
+ */
+#pragma once
+#include <array>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+template <std::unsigned_integral Key, typename T = std::size_t, std::size_t width = std::numeric_limits<Key>::digits>
+class PersistentBinaryTrie {
+private:
+    using index_type = std::uint32_t;
+    // 0号节点为空节点, 两个孩子都指向自身, 计数恒为0
+    static constexpr auto null = index_type(0);
+
+public:
+    PersistentBinaryTrie() : next(1, {null, null}), number(1, T{}), roots(1, null) {}
+
+    void clear() {
+        next.assign(1, {null, null});
+        number.assign(1, T{});
+        roots.assign(1, null);
+    }
+
+    void reserve(std::size_t keys) {
+        next.reserve(next.size() + keys * (width + 1));
+        number.reserve(number.size() + keys * (width + 1));
+        roots.reserve(roots.size() + keys);
+    }
+
+    std::size_t versions() const {
+        return roots.size();
+    }
+
+    T size(std::size_t version) const {
+        return number[roots[version]];
+    }
+
+    std::size_t insert(std::size_t version, Key key, T count = 1) {
+        auto previous = roots[version];
+        auto index = allocate_node(previous, count);
+        roots.push_back(index);
+        for (std::size_t i = width - 1; i + 1 != 0; --i) {
+            Key bit = key >> i & 1;
+            previous = next[previous][bit];
+            auto child = allocate_node(previous, count);
+            next[index][bit] = child;
+            index = child;
+        }
+        return roots.size() - 1;
+    }
+
+    T count(std::size_t version, Key key) const {
+        index_type index = roots[version];
+        for (std::size_t i = width - 1; i + 1 != 0; --i) {
+            index = next[index][key >> i & 1];
+        }
+        return number[index];
+    }
+
+    T count(std::size_t left_version, std::size_t right_version, Key key) const {
+        return count(right_version, key) - count(left_version, key);
+    }
+
+    // left_version须为right_version的历史版本, 在两者之间插入的键里求与key异或的最值及其出现次数
+    std::pair<Key, T> limit_xor(std::size_t left_version, std::size_t right_version, Key key, bool max) const {
+        index_type left = roots[left_version], right = roots[right_version];
+        if (number[right] - number[left] <= 0) {
+            return {0, 0};
+        }
+        Key res = 0;
+        for (std::size_t i = width - 1; i + 1 != 0; --i) {
+            Key bit = (key >> i & 1) ^ max;
+            bit ^= not (number[next[right][bit]] - number[next[left][bit]] > 0);
+            res |= bit << i;
+            left = next[left][bit];
+            right = next[right][bit];
+        }
+        return {res ^= key, number[right] - number[left]};
+    }
+
+    std::pair<Key, T> limit_xor(std::size_t version, Key key, bool max) const {
+        return limit_xor(0, version, key, max);
+    }
+
+private:
+    std::vector<std::array<index_type, 2>> next;
+    std::vector<T> number;
+    std::vector<index_type> roots;
+    index_type allocate_node(index_type from, T count) {
+        auto children = next[from];
+        next.push_back(children);
+        number.push_back(number[from] + count);
+        return next.size() - 1;
+    }
+};
\ No newline at end of file
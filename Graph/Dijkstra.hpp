@@ -2,19 +2,370 @@
  * @brief Dijkstra最短路算法
  * @details 支持单源最短路径查询，包括路径记录、路径计数、最短路计数等功能
  *          可通过重载比较运算符处理复杂的权值类型
+ *          freeze()将邻接表转为32位下标的CSR数组，之后的solve按CSR遍历；再次add_edge会回退到邻接表
+ *          第二个模板参数选择优先队列：LazyHeap（默认，二叉堆+懒删除）、QuaternaryHeap（带下标的四叉堆，支持decrease-key）
+ *          RadixHeap（基数堆，要求整数非负权）、ZeroOneQueue（双端队列0-1 BFS，要求边权为0或1）
+ *          BucketQueue（Dial算法的循环桶，要求整数非负权，桶数随最大边权C自动扩张）
+ *          solve(source, infinity, targets)在所有目标点出队后立即停止，未出队的点距离只是上界
+ *          bidirectional(source, target, infinity)为双向Dijkstra点对点查询，freeze(true)建立反向CSR供多次查询复用，否则每次查询临时建立
+ *          多次求解时使用Workspace复用数组，以时间戳区分本次访问过的点，单次求解只花费访问到的点和边的时间
+ *          solve_all对多个源点多线程求解，每个线程持有一个Workspace；distance_table只保留到目标点的距离，内存为O(threads * V)
+ *          dag(res)由一次求解的结果导出最短路DAG：offset[v]到offset[v + 1]为v在某条最短路上的所有前驱，存在0权环时可能含环
+ *          delta_stepping为并行单源最短路（要求算术类型的非负边权，delta > 0），按距离/delta分桶，桶内轻边(w <= delta)反复松弛，桶清空后再松弛重边
+ *          每一轮松弛由所有线程分块处理，距离用原子比较交换取最小值；delta取平均边权附近通常较好
  *          使用示例：
  *          - Dijkstra::Graph<int> adj(n); adj.add_edge(u, v, w); adj.solve(start, std::numeric_limits<int>::max() / 2);
  *          - adj.solve<true>(start, std::numeric_limits<int>::max() / 2); // 记录路径
  *          - adj.solve<false, true>(start, std::numeric_limits<int>::max() / 2); // 计数最短路
  *          - adj.solve<true, true, modint>(start, std::numeric_limits<int>::max() / 2); // 路径记录+计数（使用取模类）
- * @complexity O((V + E) log V), 其中V为顶点数，E为边数
+ *          - Dijkstra::Graph<i64, Dijkstra::RadixHeap> adj(n); ...; adj.freeze(); adj.solve(start, inf64); // CSR+基数堆
+ *          - Dijkstra::Graph<int, Dijkstra::ZeroOneQueue> adj(n); adj.solve<true, true>(start, inf32); // 0-1 BFS
+ *          - adj.freeze(true); auto [distance, path] = adj.bidirectional<true>(start, end, inf64); // 双向搜索+路径
+ *          - auto ws = adj.workspace(); for (auto s : sources) { adj.solve(ws, s, inf64); ws.distance(v); } // 复用工作区
+ *          - auto table = adj.distance_table(sources, targets, inf64); // table[i * targets.size() + j]
+ *          - auto distances = adj.delta_stepping(start, inf64, delta); // 并行单源最短路
+ * @complexity O((V + E) log V), 其中V为顶点数，E为边数; 基数堆: O(E + V log C); 0-1 BFS: O(V + E); Dial: O(V + E + D), 其中C为最大边权, D为最大距离
  */
 #pragma once
-#include <queue>
+#include <bit>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <span>
+#include <map>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <barrier>
 #include <vector>
+#include <cstdint>
+#include <concepts>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
 #include <tr2/dynamic_bitset>
 namespace Dijkstra {
+    /* 优先队列接口: Queue(vertex), push(vertex, distance), pop() -> {distance, vertex}, empty(), clear()
+     * push在顶点已在队列中时可以是decrease-key, 也可以直接插入新元素, pop出的过期元素由solve跳过 */
     template <typename Group>
+    class LazyHeap {
+    public:
+        LazyHeap(std::size_t) {}
+
+        bool empty() const {
+            return heap.empty();
+        }
+
+        void push(std::size_t vertex, const Group &distance) {
+            heap.emplace_back(distance, vertex);
+            std::push_heap(heap.begin(), heap.end(), std::greater<>());
+        }
+
+        std::pair<Group, std::size_t> pop() {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            auto top = heap.back();
+            heap.pop_back();
+            return top;
+        }
+
+        void clear() {
+            heap.clear();
+        }
+
+    private:
+        std::vector<std::pair<Group, std::size_t>> heap;
+    };
+
+    template <typename Group>
+    class QuaternaryHeap {
+    private:
+        static constexpr auto none = std::uint32_t(-1);
+
+    public:
+        QuaternaryHeap(std::size_t vertex) : position(vertex, none) {}
+
+        bool empty() const {
+            return heap.empty();
+        }
+
+        void push(std::size_t vertex, const Group &distance) {
+            if (position[vertex] == none) {
+                position[vertex] = heap.size();
+                heap.emplace_back(distance, vertex);
+            } else {
+                heap[position[vertex]].first = distance;
+            }
+            sift_up(position[vertex]);
+        }
+
+        std::pair<Group, std::size_t> pop() {
+            std::pair<Group, std::size_t> top = heap.front();
+            position[top.second] = none;
+            if (heap.size() > 1) {
+                heap.front() = heap.back();
+                position[heap.front().second] = 0;
+                heap.pop_back();
+                sift_down(0);
+            } else {
+                heap.pop_back();
+            }
+            return top;
+        }
+
+        void clear() {
+            for (const auto &[_, vertex] : heap) {
+                position[vertex] = none;
+            }
+            heap.clear();
+        }
+
+    private:
+        std::vector<std::pair<Group, std::uint32_t>> heap;
+        std::vector<std::uint32_t> position;
+        void sift_up(std::size_t index) {
+            auto node = heap[index];
+            while (index != 0) {
+                auto parent = (index - 1) >> 2;
+                if (not (node.first < heap[parent].first)) {
+                    break;
+                }
+                position[(heap[index] = heap[parent]).second] = index;
+                index = parent;
+            }
+            position[(heap[index] = node).second] = index;
+        }
+
+        void sift_down(std::size_t index) {
+            auto node = heap[index];
+            while (true) {
+                auto first = (index << 2) + 1;
+                if (first >= heap.size()) {
+                    break;
+                }
+                auto best = first;
+                for (auto child = first + 1; child < std::min(first + 4, heap.size()); ++child) {
+                    if (heap[child].first < heap[best].first) {
+                        best = child;
+                    }
+                }
+                if (not (heap[best].first < node.first)) {
+                    break;
+                }
+                position[(heap[index] = heap[best]).second] = index;
+                index = best;
+            }
+            position[(heap[index] = node).second] = index;
+        }
+    };
+
+    template <std::integral Group>
+    class RadixHeap {
+    private:
+        using key_type = std::make_unsigned_t<Group>;
+        static constexpr std::size_t bits = std::numeric_limits<key_type>::digits;
+
+    public:
+        RadixHeap(std::size_t) : _size(), last() {}
+
+        bool empty() const {
+            return _size == 0;
+        }
+
+        void push(std::size_t vertex, const Group &distance) {
+            ++_size;
+            buckets[bucket(distance)].emplace_back(distance, vertex);
+        }
+
+        std::pair<Group, std::size_t> pop() {
+            if (buckets[0].empty()) {
+                std::size_t i = 1;
+                while (buckets[i].empty()) {
+                    ++i;
+                }
+                last = std::min_element(buckets[i].begin(), buckets[i].end())->first;
+                for (const auto &[distance, vertex] : buckets[i]) {
+                    buckets[bucket(distance)].emplace_back(distance, vertex);
+                }
+                buckets[i].clear();
+            }
+            --_size;
+            std::pair<Group, std::size_t> top = buckets[0].back();
+            buckets[0].pop_back();
+            return top;
+        }
+
+        void clear() {
+            _size = 0;
+            last = 0;
+            for (auto &bucket : buckets) {
+                bucket.clear();
+            }
+        }
+
+    private:
+        std::size_t _size;
+        key_type last;
+        std::array<std::vector<std::pair<key_type, std::uint32_t>>, bits + 1> buckets;
+        std::size_t bucket(key_type distance) const {
+            return std::bit_width(static_cast<key_type>(distance ^ last));
+        }
+    };
+
+    template <typename Group>
+    class ZeroOneQueue {
+    public:
+        ZeroOneQueue(std::size_t) : current() {}
+
+        bool empty() const {
+            return deque.empty();
+        }
+
+        // 队列中的距离只有current和current + 1两种, 前者放队首, 后者放队尾
+        void push(std::size_t vertex, const Group &distance) {
+            if (distance == current) {
+                deque.emplace_front(distance, vertex);
+            } else {
+                deque.emplace_back(distance, vertex);
+            }
+        }
+
+        std::pair<Group, std::size_t> pop() {
+            std::pair<Group, std::size_t> top = deque.front();
+            deque.pop_front();
+            current = top.first;
+            return top;
+        }
+
+        void clear() {
+            current = Group{};
+            deque.clear();
+        }
+
+    private:
+        Group current;
+        std::deque<std::pair<Group, std::uint32_t>> deque;
+    };
+
+    template <std::integral Group>
+    class BucketQueue {
+    public:
+        BucketQueue(std::size_t) : _size(), current(), buckets(1) {}
+
+        bool empty() const {
+            return _size == 0;
+        }
+
+        // 队列中的距离都在[current, current + buckets.size())内, 超出时把桶数扩张到2的幂并重新分配
+        void push(std::size_t vertex, const Group &distance) {
+            if (std::size_t(distance - current) >= buckets.size()) {
+                std::vector<std::vector<std::uint32_t>> old(std::bit_ceil(std::size_t(distance - current) + 1));
+                old.swap(buckets);
+                for (std::size_t i = 0; i < old.size(); ++i) {
+                    auto &from = old[(current + i) & (old.size() - 1)];
+                    buckets[(current + i) & (buckets.size() - 1)] = std::move(from);
+                }
+            }
+            ++_size;
+            buckets[distance & (buckets.size() - 1)].push_back(vertex);
+        }
+
+        std::pair<Group, std::size_t> pop() {
+            while (buckets[current & (buckets.size() - 1)].empty()) {
+                ++current;
+            }
+            auto &bucket = buckets[current & (buckets.size() - 1)];
+            std::pair<Group, std::size_t> top{current, bucket.back()};
+            bucket.pop_back();
+            --_size;
+            return top;
+        }
+
+        void clear() {
+            _size = 0;
+            current = Group{};
+            for (auto &bucket : buckets) {
+                bucket.clear();
+            }
+        }
+
+    private:
+        std::size_t _size;
+        Group current;
+        std::vector<std::vector<std::uint32_t>> buckets;
+    };
+
+    /* 可复用的求解工作区, stamp[v]等于epoch表示本次已访问, 等于epoch + 1表示本次已出队
+     * 每次求解只需递增epoch, 不必清空数组 */
+    template <typename Group, typename CountType = std::size_t, template <typename> typename Queue = LazyHeap>
+    class Workspace {
+        template <typename, template <typename> typename>
+        friend class Graph;
+
+    public:
+        explicit Workspace(std::size_t vertex) : epoch(1), source(), infinity(), stamp(vertex), mark(vertex), distances(vertex), heap(vertex) {}
+
+        std::size_t size() const {
+            return stamp.size();
+        }
+
+        bool reached(std::size_t vertex) const {
+            return stamp[vertex] >= epoch;
+        }
+
+        Group distance(std::size_t vertex) const {
+            return reached(vertex) ? distances[vertex] : infinity;
+        }
+
+        CountType count(std::size_t vertex) const {
+            return reached(vertex) ? number[vertex] : CountType{};
+        }
+
+        bool trace(std::size_t end, auto &&call) const {
+            if (distance(end) >= infinity) {
+                return false;
+            }
+            std::vector<std::size_t> path{end};
+            while (path.back() != source) {
+                path.push_back(previous[path.back()]);
+            }
+            for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                std::forward<decltype(call)>(call)(*it);
+            }
+            return true;
+        }
+
+        std::vector<std::size_t> path(std::size_t end) const {
+            std::vector<std::size_t> res;
+            trace(end, [&](std::size_t now) -> void {
+                res.push_back(now);
+            });
+            return res;
+        }
+
+    private:
+        std::uint32_t epoch;
+        std::size_t source;
+        Group infinity;
+        std::vector<std::uint32_t> stamp;
+        std::vector<std::uint32_t> mark;
+        std::vector<Group> distances;
+        std::vector<CountType> number;
+        std::vector<std::size_t> previous;
+        Queue<Group> heap;
+        void start(std::size_t from, const Group &limit) {
+            if (epoch >= std::numeric_limits<std::uint32_t>::max() - 2) {
+                std::fill(stamp.begin(), stamp.end(), 0);
+                std::fill(mark.begin(), mark.end(), 0);
+                epoch = 1;
+            }
+            epoch += 2;
+            source = from;
+            infinity = limit;
+            heap.clear();
+        }
+    };
+
+    template <typename Group, template <typename> typename Queue = LazyHeap>
     class Graph {
     private:
         template <typename CountType>
@@ -28,15 +379,13 @@ namespace Dijkstra {
                 if (distances[end] >= infinity) {
                     return false;
                 }
-                auto dfs = [&](auto &&self, std::size_t now, auto &&call) -> void {
-                    if (now == source) {
-                        std::forward<decltype(call)>(call)(now);
-                        return;
-                    }
-                    self(self, previous[now], std::forward<decltype(call)>(call));
-                    std::forward<decltype(call)>(call)(now);
-                };
-                dfs(dfs, end, std::forward<decltype(call)>(call));
+                std::vector<std::size_t> path{end};
+                while (path.back() != source) {
+                    path.push_back(previous[path.back()]);
+                }
+                for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                    std::forward<decltype(call)>(call)(*it);
+                }
                 return true;
             }
 
@@ -49,9 +398,10 @@ namespace Dijkstra {
             }
         };
     public:
-        Graph(std::size_t vertex) : adj(vertex) {}
+        Graph(std::size_t vertex) : frozen(false), reverse_frozen(false), adj(vertex) {}
 
         void add_edge(std::size_t u, std::size_t v, const Group &weight) {
+            frozen = reverse_frozen = false;
             adj[u].emplace_back(v, weight);
         }
 
@@ -60,6 +410,7 @@ namespace Dijkstra {
         }
 
         void resize(std::size_t vertex) {
+            frozen = reverse_frozen = false;
             adj.clear();
             adj.resize(vertex);
         }
@@ -68,57 +419,415 @@ namespace Dijkstra {
             return adj[i];
         }
 
+        // 按起点排序的连续边数组, offset[u]到offset[u + 1]为u的出边; reverse为真时同时建立按终点排序的反向数组
+        void freeze(bool reverse = false) {
+            offset.assign(adj.size() + 1, 0);
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                offset[i + 1] = offset[i] + adj[i].size();
+            }
+            to.resize(offset.back());
+            cost.resize(offset.back());
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                for (std::size_t j = offset[i]; const auto &[v, w] : adj[i]) {
+                    to[j] = v;
+                    cost[j++] = w;
+                }
+            }
+            transpose = reverse ? build_transpose() : reverse_graph{};
+            reverse_frozen = reverse;
+            frozen = true;
+        }
+
+        // 所有满足dist[u] + w == dist[v]的边(u, v), 按终点v排成CSR
+        template <typename CountType>
+        [[nodiscard]] auto dag(const info<CountType> &res) const {
+            return build_dag(res.infinity, [&](std::size_t vertex) -> const Group & {
+                return res.distances[vertex];
+            });
+        }
+
+        template <typename CountType>
+        [[nodiscard]] auto dag(const Workspace<Group, CountType, Queue> &ws) const {
+            return build_dag(ws.infinity, [&](std::size_t vertex) {
+                return ws.distance(vertex);
+            });
+        }
+
+        template <typename CountType = std::size_t>
+        [[nodiscard]] auto workspace() const {
+            return Workspace<Group, CountType, Queue>(adj.size());
+        }
+
         template <bool Path = false, bool Count = false, typename CountType = std::size_t>
-        [[nodiscard]] auto solve(std::size_t source, const Group &infinity) const {
-            std::vector<Group> distances;
-            std::vector<CountType> number;
-            std::vector<std::size_t> previous;
-            std::tr2::dynamic_bitset<> visited(adj.size());
-            distances.resize(adj.size(), infinity);
+        [[nodiscard]] auto solve(std::size_t source, const Group &infinity, std::span<const std::size_t> targets = {}) const {
+            Workspace<Group, CountType, Queue> ws(adj.size());
+            search<Path, Count>(ws, source, infinity, targets);
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                if (not ws.reached(i)) {
+                    ws.distances[i] = infinity;
+                    if constexpr (Count) {
+                        ws.number[i] = CountType{};
+                    }
+                }
+            }
+            return info<CountType>{.infinity = infinity, .source = source, .distances = std::move(ws.distances), .number = std::move(ws.number), .previous = std::move(ws.previous)};
+        }
+
+        // 复用ws中的数组, 只有本次访问到的点被写入, 结果通过ws读取
+        template <bool Path = false, bool Count = false, typename CountType>
+        const Workspace<Group, CountType, Queue> &solve(Workspace<Group, CountType, Queue> &ws, std::size_t source, const Group &infinity, std::span<const std::size_t> targets = {}) const {
+            search<Path, Count>(ws, source, infinity, targets);
+            return ws;
+        }
+
+        // 各线程从共享计数器领取源点, call(i, ws)在工作线程中调用, 需要自行保证线程安全
+        template <bool Path = false, bool Count = false, typename CountType = std::size_t>
+        void solve_all(std::span<const std::size_t> sources, const Group &infinity, auto &&call, std::span<const std::size_t> targets = {}, std::size_t threads = std::thread::hardware_concurrency()) const {
+            if (sources.empty()) {
+                return;
+            }
+            threads = std::clamp<std::size_t>(threads, 1, sources.size());
+            std::atomic<std::size_t> next = 0;
+            auto worker = [&]() {
+                Workspace<Group, CountType, Queue> ws(adj.size());
+                for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < sources.size();) {
+                    search<Path, Count>(ws, sources[i], infinity, targets);
+                    call(i, std::as_const(ws));
+                }
+            };
+            std::vector<std::jthread> pool;
+            for (std::size_t i = 1; i < threads; ++i) {
+                pool.emplace_back(worker);
+            }
+            worker();
+        }
+
+        [[nodiscard]] std::vector<Group> distance_table(std::span<const std::size_t> sources, std::span<const std::size_t> targets, const Group &infinity, std::size_t threads = std::thread::hardware_concurrency()) const {
+            std::vector<Group> res(sources.size() * targets.size());
+            if (targets.empty()) {
+                return res;
+            }
+            solve_all(sources, infinity, [&](std::size_t i, const auto &ws) {
+                for (std::size_t j = 0; j < targets.size(); ++j) {
+                    res[i * targets.size() + j] = ws.distance(targets[j]);
+                }
+            }, targets, threads);
+            return res;
+        }
+
+        [[nodiscard]] std::vector<Group> delta_stepping(std::size_t source, const Group &infinity, const Group &delta, std::size_t threads = std::thread::hardware_concurrency()) const
+            requires std::is_arithmetic_v<Group>
+        {
+            constexpr std::size_t grain = 64;
+            threads = std::max<std::size_t>(threads, 1);
+            std::vector<Group> distances(adj.size(), infinity);
+            std::vector<std::uint32_t> seen(adj.size()), done(adj.size());
+            std::vector<std::uint32_t> frontier, settled;
+            std::vector<std::vector<std::uint32_t>> outbox(threads);
+            std::map<std::size_t, std::vector<std::uint32_t>> buckets;
+            const std::vector<std::uint32_t> *items = nullptr;
+            bool heavy = false, stop = false;
+            std::atomic<std::size_t> cursor = 0;
+            std::barrier sync(threads);
+            // delta必须为正; 不为正时退化为最小的正步长(整数为1, 浮点为最小正规数), 商超出size_t时并入最后一个桶
+            assert(delta > Group{});
+            const Group step = delta > Group{} ? delta : std::is_integral_v<Group> ? Group(1) : std::numeric_limits<Group>::min();
+            auto bucket = [&](const Group &distance) -> std::size_t {
+                if constexpr (std::is_floating_point_v<Group>) {
+                    auto quotient = distance / step;
+                    return quotient < static_cast<Group>(std::numeric_limits<std::size_t>::max()) ? static_cast<std::size_t>(quotient) : std::numeric_limits<std::size_t>::max();
+                } else {
+                    return distance / step;
+                }
+            };
+
+            // 分块领取items中的点, 松弛其轻边或重边, 距离被改小的点记入本线程的outbox
+            auto relax = [&](std::size_t id) {
+                for (std::size_t begin; (begin = cursor.fetch_add(grain, std::memory_order_relaxed)) < items->size();) {
+                    for (auto k = begin; k < std::min(begin + grain, items->size()); ++k) {
+                        auto vertex = (*items)[k];
+                        auto distance = std::atomic_ref<Group>(distances[vertex]).load(std::memory_order_relaxed);
+                        for_each_edge(vertex, [&](std::size_t neighbor, const Group &weight) {
+                            if ((step < weight) != heavy) {
+                                return;
+                            }
+                            auto new_dist = distance + weight;
+                            std::atomic_ref<Group> target(distances[neighbor]);
+                            for (auto old = target.load(std::memory_order_relaxed); new_dist < old;) {
+                                if (target.compare_exchange_weak(old, new_dist, std::memory_order_relaxed)) {
+                                    outbox[id].push_back(neighbor);
+                                    break;
+                                }
+                            }
+                        });
+                    }
+                }
+            };
+
+            auto run = [&](const std::vector<std::uint32_t> &work, bool kind) {
+                items = &work;
+                heavy = kind;
+                cursor = 0;
+                sync.arrive_and_wait();
+                relax(0);
+                sync.arrive_and_wait();
+                for (auto &list : outbox) {
+                    for (auto vertex : list) {
+                        buckets[bucket(distances[vertex])].push_back(vertex);
+                    }
+                    list.clear();
+                }
+            };
+
+            std::vector<std::jthread> pool;
+            for (std::size_t id = 1; id < threads; ++id) {
+                pool.emplace_back([&, id]() {
+                    while (sync.arrive_and_wait(), not stop) {
+                        relax(id);
+                        sync.arrive_and_wait();
+                    }
+                });
+            }
+
             distances[source] = Group{};
+            buckets[0].push_back(source);
+            for (std::uint32_t round = 1, phase = 1; not buckets.empty(); ++round) {
+                auto index = buckets.begin()->first;
+                settled.clear();
+                for (auto it = buckets.begin(); it != buckets.end() and it->first == index; it = buckets.begin(), ++phase) {
+                    auto list = std::move(it->second);
+                    buckets.erase(it);
+                    frontier.clear();
+                    for (auto vertex : list) {
+                        if (seen[vertex] != phase and bucket(distances[vertex]) == index) {
+                            seen[vertex] = phase;
+                            frontier.push_back(vertex);
+                            if (done[vertex] != round) {
+                                done[vertex] = round;
+                                settled.push_back(vertex);
+                            }
+                        }
+                    }
+                    run(frontier, false);
+                }
+                run(settled, true);
+            }
+            stop = true;
+            sync.arrive_and_wait();
+            return distances;
+        }
+
+        // 两侧交替出队, 两侧最近出队的距离之和不小于当前最优值时停止
+        // 没有有效的反向CSR时(未调用freeze(true), 或之后又加了边)在本次查询内临时由邻接表建立
+        template <bool Path = false>
+        [[nodiscard]] auto bidirectional(std::size_t source, std::size_t target, const Group &infinity) const {
+            struct route {
+                Group distance;
+                std::vector<std::size_t> path;
+            };
+            reverse_graph local;
+            if (not reverse_frozen) {
+                local = build_transpose();
+            }
+            const auto &backward = reverse_frozen ? transpose : local;
+            std::array<std::vector<Group>, 2> distances{std::vector<Group>(adj.size(), infinity), std::vector<Group>(adj.size(), infinity)};
+            std::array<std::vector<std::size_t>, 2> previous;
+            std::array<std::tr2::dynamic_bitset<>, 2> visited{std::tr2::dynamic_bitset<>(adj.size()), std::tr2::dynamic_bitset<>(adj.size())};
+            std::array<Queue<Group>, 2> heap{Queue<Group>(adj.size()), Queue<Group>(adj.size())};
+            std::array<Group, 2> last{};
+            if constexpr (Path) {
+                previous[0].resize(adj.size());
+                previous[1].resize(adj.size());
+            }
+            Group best = source == target ? Group{} : infinity;
+            std::size_t meet = source;
+            distances[0][source] = distances[1][target] = Group{};
+            heap[0].push(source, Group{});
+            heap[1].push(target, Group{});
+            for (std::size_t side = 0; not heap[0].empty() and not heap[1].empty(); side ^= 1) {
+                auto [distance, vertex] = heap[side].pop();
+                if (visited[side].test(vertex)) {
+                    continue;
+                }
+                visited[side].set(vertex);
+                if (last[side] = distance; not (last[0] + last[1] < best)) {
+                    break;
+                }
+                auto relax = [&](std::size_t neighbor, const Group &weight) {
+                    auto new_dist = distances[side][vertex] + weight;
+                    if (distances[side][neighbor] > new_dist) {
+                        distances[side][neighbor] = new_dist;
+                        heap[side].push(neighbor, new_dist);
+                        if constexpr (Path) {
+                            previous[side][neighbor] = vertex;
+                        }
+                        if (distances[side ^ 1][neighbor] < infinity and new_dist + distances[side ^ 1][neighbor] < best) {
+                            best = new_dist + distances[side ^ 1][neighbor];
+                            meet = neighbor;
+                        }
+                    }
+                };
+                if (side == 0) {
+                    for_each_edge(vertex, relax);
+                } else {
+                    for (std::size_t i = backward.offset[vertex]; i != backward.offset[vertex + 1]; ++i) {
+                        relax(backward.to[i], backward.cost[i]);
+                    }
+                }
+            }
+            route res{.distance = best, .path = {}};
+            if constexpr (Path) {
+                if (best < infinity) {
+                    for (auto now = meet; now != source; now = previous[0][now]) {
+                        res.path.push_back(now);
+                    }
+                    res.path.push_back(source);
+                    std::reverse(res.path.begin(), res.path.end());
+                    for (auto now = meet; now != target;) {
+                        res.path.push_back(now = previous[1][now]);
+                    }
+                }
+            }
+            return res;
+        }
+
+    private:
+        // 按终点排序的反向CSR, offset[v]到offset[v + 1]为v的入边
+        struct reverse_graph {
+            std::vector<std::size_t> offset;
+            std::vector<std::uint32_t> to;
+            std::vector<Group> cost;
+        };
 
+        bool frozen, reverse_frozen;
+        std::vector<std::vector<std::pair<std::size_t, Group>>> adj;
+        std::vector<std::size_t> offset;
+        std::vector<std::uint32_t> to;
+        std::vector<Group> cost;
+        reverse_graph transpose;
+        // 所有目标点出队后提前结束, targets为空时求出全部最短路
+        template <bool Path, bool Count, typename CountType>
+        void search(Workspace<Group, CountType, Queue> &ws, std::size_t source, const Group &infinity, std::span<const std::size_t> targets) const {
+            ws.start(source, infinity);
             if constexpr (Path) {
-                previous.resize(adj.size());
+                ws.previous.resize(adj.size());
             }
 
             if constexpr (Count) {
-                number.resize(adj.size());
-                number[source] = CountType{1};
+                ws.number.resize(adj.size());
+                ws.number[source] = CountType{1};
             }
 
-            std::priority_queue<std::pair<Group, std::size_t>, std::vector<std::pair<Group, std::size_t>>, std::greater<>> heap;
-            heap.emplace(Group{}, source);
+            std::size_t remain = 0;
+            for (auto target : targets) {
+                if (ws.mark[target] != ws.epoch) {
+                    ws.mark[target] = ws.epoch;
+                    ++remain;
+                }
+            }
 
-            while (not heap.empty()) {
-                auto [_, vertex] = heap.top();
-                heap.pop();
-                if (visited.test(vertex)) {
+            ws.stamp[source] = ws.epoch;
+            ws.distances[source] = Group{};
+            ws.heap.push(source, Group{});
+
+            while (not ws.heap.empty()) {
+                auto [_, vertex] = ws.heap.pop();
+                if (ws.stamp[vertex] != ws.epoch) {
                     continue;
                 }
-                visited.set(vertex);
-                for (const auto &[neighbor, weight] : adj[vertex]) {
-                    auto &neighbor_dist = distances[neighbor];
-                    auto new_dist = distances[vertex] + weight;
-                    if (neighbor_dist > new_dist) {
-                        neighbor_dist = new_dist;
+                ws.stamp[vertex] = ws.epoch + 1;
+                if (ws.mark[vertex] == ws.epoch and --remain == 0) {
+                    break;
+                }
+                for_each_edge(vertex, [&](std::size_t neighbor, const Group &weight) {
+                    bool fresh = not ws.reached(neighbor);
+                    auto new_dist = ws.distances[vertex] + weight;
+                    if (fresh ? infinity > new_dist : ws.distances[neighbor] > new_dist) {
+                        if (fresh) {
+                            ws.stamp[neighbor] = ws.epoch;
+                        }
+                        ws.distances[neighbor] = new_dist;
                         if constexpr (Count) {
-                            number[neighbor] = number[vertex];
+                            ws.number[neighbor] = ws.number[vertex];
                         }
-                        heap.emplace(neighbor_dist, neighbor);
+                        ws.heap.push(neighbor, new_dist);
                         if constexpr (Path) {
-                            previous[neighbor] = vertex;
+                            ws.previous[neighbor] = vertex;
                         }
-                    } else if (neighbor_dist == new_dist) {
+                    } else if (not fresh and ws.distances[neighbor] == new_dist) {
                         if constexpr (Count) {
-                            number[neighbor] += number[vertex];
+                            ws.number[neighbor] += ws.number[vertex];
                         }
                     }
+                });
+            }
+        }
+
+        auto build_dag(const Group &infinity, auto &&distance) const {
+            struct result {
+                std::vector<std::size_t> offset;
+                std::vector<std::uint32_t> previous;
+            };
+            result res{.offset = std::vector<std::size_t>(adj.size() + 1), .previous = {}};
+            auto for_each_tight = [&](auto &&call) {
+                for (std::size_t vertex = 0; vertex < adj.size(); ++vertex) {
+                    if (distance(vertex) >= infinity) {
+                        continue;
+                    }
+                    for_each_edge(vertex, [&](std::size_t neighbor, const Group &weight) {
+                        if (distance(vertex) + weight == distance(neighbor)) {
+                            call(vertex, neighbor);
+                        }
+                    });
                 }
+            };
+            for_each_tight([&](std::size_t, std::size_t neighbor) {
+                ++res.offset[neighbor + 1];
+            });
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                res.offset[i + 1] += res.offset[i];
             }
-            return info<CountType>{.infinity = infinity, .source = source, .distances = distances, .number = number, .previous = previous};
+            res.previous.resize(res.offset.back());
+            std::vector<std::size_t> position(res.offset.begin(), res.offset.end() - 1);
+            for_each_tight([&](std::size_t vertex, std::size_t neighbor) {
+                res.previous[position[neighbor]++] = vertex;
+            });
+            return res;
         }
 
-    private:
-        std::vector<std::vector<std::pair<std::size_t, Group>>> adj;
+        // 直接由邻接表建立, 不依赖正向CSR是否最新
+        reverse_graph build_transpose() const {
+            reverse_graph res{std::vector<std::size_t>(adj.size() + 1), {}, {}};
+            for (const auto &list : adj) {
+                for (const auto &[v, w] : list) {
+                    ++res.offset[v + 1];
+                }
+            }
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                res.offset[i + 1] += res.offset[i];
+            }
+            res.to.resize(res.offset.back());
+            res.cost.resize(res.offset.back());
+            std::vector<std::size_t> position(res.offset.begin(), res.offset.end() - 1);
+            for (std::size_t u = 0; u < adj.size(); ++u) {
+                for (const auto &[v, w] : adj[u]) {
+                    res.to[position[v]] = u;
+                    res.cost[position[v]++] = w;
+                }
+            }
+            return res;
+        }
+
+        void for_each_edge(std::size_t vertex, auto &&call) const {
+            if (frozen) {
+                for (std::size_t i = offset[vertex]; i != offset[vertex + 1]; ++i) {
+                    call(to[i], cost[i]);
+                }
+            } else {
+                for (const auto &[neighbor, weight] : adj[vertex]) {
+                    call(neighbor, weight);
+                }
+            }
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,428 @@
+/**
+ * @brief Dinic最大流与原始对偶费用流
+ * @details 所有边与反向边成对存放在同一个按起点排序的CSR数组中，每条弧记录终点、反向弧下标和剩余容量
+ *          Graph为Dinic最大流：BFS建分层图，迭代DFS沿当前弧增广，死点从分层图中删除；scaling = true时按容量从高位到低位分阶段增广（要求整数容量）
+ *          CostGraph为最小费用流：每轮用Dijkstra求带势能的约简距离并更新势能，再在约简费用为0的弧上用当前弧DFS多路增广
+ *          优先队列沿用Dijkstra::Graph的Queue接口，输入存在负费用边时先用Bellman-Ford求初始势能（要求无负环），势能跨多次solve沿用，同一源点续算时不再重跑
+ *          add_edge返回边的编号，flow(id)查询该边上的流量；求解后再次add_edge会按原始容量重建，之前的流量作废
+ *          使用示例：
+ *          - Dinic::Graph<i64> g(n); g.add_edge(u, v, c); auto flow = g.solve(s, t); auto cut = g.min_cut(s);
+ *          - Dinic::CostGraph<i64, i64> g(n); g.add_edge(u, v, c, w); auto [flow, cost] = g.solve(s, t, limit);
+ * @complexity Dinic: O(V^2 * E), 单位容量图O(E * sqrt(E)); 容量缩放: O(V * E * log C); 费用流: O(F * (V + E) log V), 其中F为增广轮数
+ */
+#pragma once
+#include <bit>
+#include <tuple>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <concepts>
+#include <algorithm>
+#include <tr2/dynamic_bitset>
+#include "Dijkstra.hpp"
+namespace Dinic {
+    constexpr auto invalid = std::numeric_limits<std::uint32_t>::max();
+
+    template <typename Cap>
+    class Graph {
+    public:
+        Graph(std::size_t vertex) : n(vertex), frozen(false) {}
+
+        std::size_t size() const {
+            return n;
+        }
+
+        std::size_t add_edge(std::size_t u, std::size_t v, const Cap &capacity, const Cap &reverse_capacity = Cap{}) {
+            frozen = false;
+            edges.emplace_back(u, v, capacity, reverse_capacity);
+            return edges.size() - 1;
+        }
+
+        // 在当前残量网络上继续增广, 返回新增的流量
+        Cap solve(std::size_t source, std::size_t sink, bool scaling = false) {
+            freeze();
+            Cap res{};
+            if (source == sink) {
+                return res;
+            }
+            if constexpr (std::integral<Cap>) {
+                if (scaling) {
+                    Cap max{};
+                    for (const auto &arc : arcs) {
+                        max = std::max(max, arc.cap);
+                    }
+                    for (Cap delta = max > 0 ? std::bit_floor(static_cast<std::make_unsigned_t<Cap>>(max)) : 0; delta > 0; delta >>= 1) {
+                        res += augment(source, sink, delta - 1);
+                    }
+                    return res;
+                }
+            }
+            return augment(source, sink, Cap{});
+        }
+
+        Cap flow(std::size_t id) const {
+            return frozen ? std::get<2>(edges[id]) - arcs[position[id]].cap : Cap{};
+        }
+
+        // 残量网络中从source出发可达的点集, 即最小割的源点一侧
+        [[nodiscard]] std::tr2::dynamic_bitset<> min_cut(std::size_t source) {
+            freeze();
+            std::tr2::dynamic_bitset<> visited(n);
+            std::vector<std::uint32_t> queue{static_cast<std::uint32_t>(source)};
+            visited.set(source);
+            for (std::size_t head = 0; head < queue.size(); ++head) {
+                auto u = queue[head];
+                for (auto a = offset[u]; a < offset[u + 1]; ++a) {
+                    if (auto v = arcs[a].to; Cap{} < arcs[a].cap and not visited.test(v)) {
+                        visited.set(v);
+                        queue.push_back(v);
+                    }
+                }
+            }
+            return visited;
+        }
+
+    private:
+        struct arc {
+            std::uint32_t to, reverse;
+            Cap cap;
+        };
+
+        std::size_t n;
+        bool frozen;
+        std::vector<std::tuple<std::uint32_t, std::uint32_t, Cap, Cap>> edges;
+        std::vector<std::uint32_t> offset, position, level, cursor, path;
+        std::vector<arc> arcs;
+        void freeze() {
+            if (frozen) {
+                return;
+            }
+            offset.assign(n + 1, 0);
+            for (const auto &[u, v, capacity, reverse_capacity] : edges) {
+                ++offset[u + 1];
+                ++offset[v + 1];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                offset[i + 1] += offset[i];
+            }
+            std::vector<std::uint32_t> fill(offset.begin(), offset.end() - 1);
+            arcs.resize(offset[n]);
+            position.resize(edges.size());
+            for (std::size_t id = 0; const auto &[u, v, capacity, reverse_capacity] : edges) {
+                auto a = fill[u]++, b = fill[v]++;
+                arcs[a] = {v, b, capacity};
+                arcs[b] = {u, a, reverse_capacity};
+                position[id++] = a;
+            }
+            level.resize(n);
+            cursor.resize(n);
+            frozen = true;
+        }
+
+        // 只使用剩余容量大于threshold的弧, 反复建分层图并求阻塞流
+        Cap augment(std::size_t source, std::size_t sink, const Cap &threshold) {
+            Cap res{};
+            while (bfs(source, sink, threshold)) {
+                std::copy(offset.begin(), offset.end() - 1, cursor.begin());
+                res += dfs(source, sink, threshold);
+            }
+            return res;
+        }
+
+        bool bfs(std::size_t source, std::size_t sink, const Cap &threshold) {
+            std::fill(level.begin(), level.end(), invalid);
+            path.assign(1, source);
+            level[source] = 0;
+            for (std::size_t head = 0; head < path.size() and level[sink] == invalid; ++head) {
+                auto u = path[head];
+                for (auto a = offset[u]; a < offset[u + 1]; ++a) {
+                    if (auto v = arcs[a].to; threshold < arcs[a].cap and level[v] == invalid) {
+                        level[v] = level[u] + 1;
+                        path.push_back(v);
+                    }
+                }
+            }
+            return level[sink] != invalid;
+        }
+
+        // path为当前路径上的弧, 到达汇点后按瓶颈增广并退回到第一条饱和弧的起点; 走不通的点层数置为invalid
+        Cap dfs(std::size_t source, std::size_t sink, const Cap &threshold) {
+            Cap res{};
+            path.clear();
+            for (std::size_t u = source;;) {
+                if (u == sink) {
+                    auto bottleneck = arcs[path[0]].cap;
+                    for (auto a : path) {
+                        bottleneck = std::min(bottleneck, arcs[a].cap);
+                    }
+                    std::size_t retreat = path.size();
+                    for (std::size_t i = 0; i < path.size(); ++i) {
+                        arcs[path[i]].cap -= bottleneck;
+                        arcs[arcs[path[i]].reverse].cap += bottleneck;
+                        if (retreat == path.size() and not (threshold < arcs[path[i]].cap)) {
+                            retreat = i;
+                        }
+                    }
+                    res += bottleneck;
+                    path.resize(retreat);
+                    u = path.empty() ? source : arcs[path.back()].to;
+                    continue;
+                }
+                auto &a = cursor[u];
+                while (a < offset[u + 1] and not (threshold < arcs[a].cap and level[arcs[a].to] == level[u] + 1)) {
+                    ++a;
+                }
+                if (a < offset[u + 1]) {
+                    path.push_back(a);
+                    u = arcs[a].to;
+                } else if (u == source) {
+                    return res;
+                } else {
+                    level[u] = invalid;
+                    path.pop_back();
+                    u = path.empty() ? source : arcs[path.back()].to;
+                }
+            }
+        }
+    };
+
+    template <typename Cap, typename Cost, template <typename> typename Queue = Dijkstra::LazyHeap>
+    class CostGraph {
+    public:
+        CostGraph(std::size_t vertex) : n(vertex), frozen(false) {}
+
+        std::size_t size() const {
+            return n;
+        }
+
+        std::size_t add_edge(std::size_t u, std::size_t v, const Cap &capacity, const Cost &cost) {
+            frozen = false;
+            edges.emplace_back(u, v, capacity, cost);
+            return edges.size() - 1;
+        }
+
+        // 在当前残量网络上继续增广至多limit的流量, 返回{新增流量, 新增费用}
+        std::pair<Cap, Cost> solve(std::size_t source, std::size_t sink, Cap limit = std::numeric_limits<Cap>::max()) {
+            freeze();
+            Cap flow{};
+            Cost total{};
+            if (source == sink) {
+                return {flow, total};
+            }
+            if (verified != everywhere and verified != source) {
+                bellman_ford(source);
+                verified = source;
+            }
+            while (flow < limit and dijkstra(source, sink)) {
+                auto [pushed, cost] = dfs(source, sink, limit - flow);
+                if (pushed == Cap{}) {
+                    std::tie(pushed, cost) = augment_tree(source, sink, limit - flow);
+                }
+                flow += pushed;
+                total += cost;
+            }
+            return {flow, total};
+        }
+
+        Cap flow(std::size_t id) const {
+            return frozen ? std::get<2>(edges[id]) - arcs[position[id]].cap : Cap{};
+        }
+
+    private:
+        static constexpr auto infinity = std::numeric_limits<Cost>::max();
+        // verified记录当前势能在哪些残量弧上有效: everywhere为全部, 否则为从该源点可达的部分, nowhere为尚未求过
+        // 只看输入是否有负费用弧不够: 增广后反向弧总带负费用, 但dijkstra的更新保持约简费用非负, 势能可以沿用
+        static constexpr auto nowhere = std::numeric_limits<std::size_t>::max(), everywhere = nowhere - 1;
+        struct arc {
+            std::uint32_t to, reverse;
+            Cap cap;
+            Cost cost;
+        };
+
+        std::size_t n;
+        bool frozen;
+        std::vector<std::tuple<std::uint32_t, std::uint32_t, Cap, Cost>> edges;
+        std::vector<std::uint32_t> offset, position, cursor, previous, path, settled;
+        std::vector<Cost> potential, distance;
+        std::vector<arc> arcs;
+        std::tr2::dynamic_bitset<> on_path;
+        std::uint32_t epoch = 0;
+        std::size_t verified = nowhere;
+        void freeze() {
+            if (frozen) {
+                return;
+            }
+            offset.assign(n + 1, 0);
+            for (const auto &[u, v, capacity, cost] : edges) {
+                ++offset[u + 1];
+                ++offset[v + 1];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                offset[i + 1] += offset[i];
+            }
+            std::vector<std::uint32_t> fill(offset.begin(), offset.end() - 1);
+            arcs.resize(offset[n]);
+            position.resize(edges.size());
+            for (std::size_t id = 0; const auto &[u, v, capacity, cost] : edges) {
+                auto a = fill[u]++, b = fill[v]++;
+                arcs[a] = {v, b, capacity, cost};
+                arcs[b] = {u, a, Cap{}, -cost};
+                position[id++] = a;
+            }
+            cursor.resize(n);
+            previous.resize(n);
+            settled.assign(n, 0);
+            potential.assign(n, Cost{});
+            distance.resize(n);
+            on_path.resize(n);
+            epoch = 0;
+            verified = std::any_of(edges.begin(), edges.end(), [](const auto &edge) {
+                return Cap{} < std::get<2>(edge) and std::get<3>(edge) < Cost{};
+            }) ? nowhere : everywhere;
+            frozen = true;
+        }
+
+        Cost reduced(std::uint32_t u, const arc &a) const {
+            return a.cost + potential[u] - potential[a.to];
+        }
+
+        void bellman_ford(std::size_t source) {
+            std::fill(distance.begin(), distance.end(), infinity);
+            distance[source] = Cost{};
+            for (std::size_t round = 0; round < n; ++round) {
+                bool changed = false;
+                for (std::uint32_t u = 0; u < n; ++u) {
+                    if (distance[u] == infinity) {
+                        continue;
+                    }
+                    for (auto a = offset[u]; a < offset[u + 1]; ++a) {
+                        if (Cap{} < arcs[a].cap and distance[u] + reduced(u, arcs[a]) < distance[arcs[a].to]) {
+                            distance[arcs[a].to] = distance[u] + reduced(u, arcs[a]);
+                            changed = true;
+                        }
+                    }
+                }
+                if (not changed) {
+                    break;
+                }
+            }
+            for (std::size_t v = 0; v < n; ++v) {
+                if (distance[v] != infinity) {
+                    potential[v] += distance[v];
+                }
+            }
+        }
+
+        // 汇点出队即停止; 已出队的点势能加上distance[v] - distance[sink], 其余点不变, 所有残量弧的约简费用仍非负
+        bool dijkstra(std::size_t source, std::size_t sink) {
+            ++epoch;
+            Queue<Cost> queue(n);
+            std::fill(distance.begin(), distance.end(), infinity);
+            distance[source] = Cost{};
+            queue.push(source, Cost{});
+            path.clear();
+            while (not queue.empty()) {
+                auto [dist, u] = queue.pop();
+                if (settled[u] == epoch or distance[u] < dist) {
+                    continue;
+                }
+                settled[u] = epoch;
+                path.push_back(u);
+                if (u == sink) {
+                    break;
+                }
+                for (auto a = offset[u]; a < offset[u + 1]; ++a) {
+                    auto v = arcs[a].to;
+                    if (Cap{} < arcs[a].cap and settled[v] != epoch) {
+                        if (auto new_dist = dist + reduced(u, arcs[a]); new_dist < distance[v]) {
+                            distance[v] = new_dist;
+                            previous[v] = a;
+                            queue.push(v, new_dist);
+                        }
+                    }
+                }
+            }
+            if (settled[sink] != epoch) {
+                return false;
+            }
+            for (auto v : path) {
+                potential[v] += distance[v] - distance[sink];
+            }
+            return true;
+        }
+
+        // 在已出队的点之间, 沿约简费用为0的弧做当前弧DFS多路增广, on_path防止沿0费用环打转
+        std::pair<Cap, Cost> dfs(std::size_t source, std::size_t sink, Cap limit) {
+            Cap flow{};
+            Cost total{};
+            for (auto v : path) {
+                cursor[v] = offset[v];
+            }
+            path.clear();
+            on_path.reset();
+            on_path.set(source);
+            for (std::size_t u = source; flow < limit;) {
+                if (u == sink) {
+                    auto bottleneck = limit - flow;
+                    Cost cost{};
+                    for (auto a : path) {
+                        bottleneck = std::min(bottleneck, arcs[a].cap);
+                        cost += arcs[a].cost;
+                    }
+                    std::size_t retreat = path.size();
+                    for (std::size_t i = 0; i < path.size(); ++i) {
+                        arcs[path[i]].cap -= bottleneck;
+                        arcs[arcs[path[i]].reverse].cap += bottleneck;
+                        if (retreat == path.size() and not (Cap{} < arcs[path[i]].cap)) {
+                            retreat = i;
+                        }
+                    }
+                    flow += bottleneck;
+                    total += cost * bottleneck;
+                    for (auto i = retreat; i < path.size(); ++i) {
+                        on_path.reset(arcs[path[i]].to);
+                    }
+                    path.resize(retreat);
+                    u = path.empty() ? source : arcs[path.back()].to;
+                    continue;
+                }
+                auto &a = cursor[u];
+                while (a < offset[u + 1]) {
+                    auto v = arcs[a].to;
+                    if (Cap{} < arcs[a].cap and settled[v] == epoch and not on_path.test(v) and reduced(u, arcs[a]) == Cost{}) {
+                        break;
+                    }
+                    ++a;
+                }
+                if (a < offset[u + 1]) {
+                    path.push_back(a);
+                    u = arcs[a].to;
+                    on_path.set(u);
+                } else if (u == source) {
+                    break;
+                } else {
+                    settled[u] = 0;
+                    on_path.reset(u);
+                    path.pop_back();
+                    u = path.empty() ? source : arcs[path.back()].to;
+                }
+            }
+            return {flow, total};
+        }
+
+        // 浮点误差使约简费用不为0时, 退化为沿最短路树增广一条路径
+        std::pair<Cap, Cost> augment_tree(std::size_t source, std::size_t sink, Cap limit) {
+            Cost cost{};
+            for (auto v = sink; v != source; v = arcs[arcs[previous[v]].reverse].to) {
+                limit = std::min(limit, arcs[previous[v]].cap);
+                cost += arcs[previous[v]].cost;
+            }
+            for (auto v = sink; v != source; v = arcs[arcs[previous[v]].reverse].to) {
+                arcs[previous[v]].cap -= limit;
+                arcs[arcs[previous[v]].reverse].cap += limit;
+            }
+            return {limit, cost * limit};
+        }
+    };
+}
\ No newline at end of file
@@ -1,14 +1,27 @@
 /**
  * @brief Floyd算法（单源最短路的简化版本）
- * @details 基于Floyd-Warshall思想的单源最短路实现，一般情况下推荐使用Dijkstra
+ * @details 基于Floyd-Warshall思想的全源最短路实现，一般情况下推荐使用Dijkstra
+ *          距离矩阵按行优先存放在连续数组中，并按block×block分块：每轮先做对角块，再做同行同列的块，最后做其余块
+ *          其余块只做min-plus乘法，彼此独立，可以多线程并行；算术类型的行内更新使用std::experimental::simd
  *          使用示例：Floyd::Graph<int> adj(n); adj.add_edge(u, v, w); auto res = adj.solve(start, std::numeric_limits<int>::max() / 2);
+ *                    auto matrix = adj.solve_all(std::numeric_limits<int>::max() / 2, 4); matrix[i * n + j];
  * @complexity O(V^3), 其中V为顶点数
  */
 #pragma once
+#include <array>
+#include <atomic>
+#include <thread>
 #include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <experimental/simd>
 namespace Floyd {
     template <typename Group>
     class Graph {
+    private:
+        static constexpr std::size_t block = 64;
+
     public:
         Graph(std::size_t vertex) : adj(vertex) {}
 
@@ -30,28 +43,130 @@ namespace Floyd {
         }
 
         [[nodiscard]] auto solve(std::size_t source, const Group &infinity) const {
-            std::vector distances(adj.size(), std::vector<Group>(adj.size(), infinity));
+            auto matrix = solve_all(infinity);
+            std::vector distances(adj.size(), std::vector<Group>(adj.size()));
             for (std::size_t i = 0; i < adj.size(); ++i) {
-                distances[i][i] = Group{};
+                std::copy_n(matrix.begin() + i * adj.size(), adj.size(), distances[i].begin());
             }
+            return distances;
+        }
 
+        // 返回行优先的V×V距离矩阵, res[i * size() + j]为i到j的最短距离, threads为每一轮并行处理块的线程数
+        [[nodiscard]] std::vector<Group> solve_all(const Group &infinity, std::size_t threads = 1) const {
+            std::size_t count = (adj.size() + block - 1) / block, stride = count * block;
+            std::vector<Group> distances(stride * stride, infinity);
+            for (std::size_t i = 0; i < stride; ++i) {
+                distances[i * stride + i] = Group{};
+            }
             for (std::size_t i = 0; i < adj.size(); ++i) {
                 for (const auto &[j, weight] : adj[i]) {
-                    distances[i][j] = weight;
+                    distances[i * stride + j] = std::min(distances[i * stride + j], weight);
                 }
             }
 
-            for (std::size_t k = 0; k < adj.size(); ++k) {
-                for (std::size_t i = 0; i < adj.size(); ++i) {
-                    for (std::size_t j = 0; j < adj.size(); ++j) {
-                        distances[i][j] = std::min(distances[i][j], distances[i][k] + distances[k][j]);
+            const auto at = [&](std::size_t row, std::size_t column) {
+                return distances.data() + row * block * stride + column * block;
+            };
+            for (std::size_t k = 0; k < count; ++k) {
+                relax_ordered(at(k, k), at(k, k), at(k, k), stride);
+                parallel(2 * count, threads, [&](std::size_t index) {
+                    if (auto other = index >> 1; other != k) {
+                        index & 1 ? relax_ordered(at(other, k), at(other, k), at(k, k), stride) : relax_ordered(at(k, other), at(k, k), at(k, other), stride);
                     }
-                }
+                });
+                parallel(count * count, threads, [&](std::size_t index) {
+                    if (auto i = index / count, j = index % count; i != k and j != k) {
+                        relax(at(i, j), at(i, k), at(k, j), stride);
+                    }
+                });
             }
 
+            if (stride != adj.size()) {
+                for (std::size_t i = 0; i < adj.size(); ++i) {
+                    std::copy_n(distances.begin() + i * stride, adj.size(), distances.begin() + i * adj.size());
+                }
+                distances.resize(adj.size() * adj.size());
+            }
             return distances;
         }
+
     private:
         std::vector<std::vector<std::pair<std::size_t, Group>>> adj;
+        static constexpr bool vectorized = std::is_arithmetic_v<Group> and not std::is_same_v<Group, bool>;
+        // row[j] = min(row[j], through + from[j])
+        static void relax_row(Group *row, const Group *from, const Group through) {
+            for (std::size_t j = 0; j < block; ++j) {
+                row[j] = std::min<Group>(row[j], through + from[j]);
+            }
+        }
+
+        // 块内包含中转点本身时必须以中转点为最外层循环, 与原始三重循环的更新顺序一致
+        static void relax_ordered(Group *target, const Group *left, const Group *right, std::size_t stride) {
+            for (std::size_t k = 0; k < block; ++k) {
+                for (std::size_t i = 0; i < block; ++i) {
+                    relax_row(target + i * stride, right + k * stride, left[i * stride + k]);
+                }
+            }
+        }
+
+        // 与中转块无关的块即一次min-plus乘法, 以i-k-j顺序遍历, 算术类型的目标行整行留在simd寄存器中
+        static void relax(Group *target, const Group *left, const Group *right, std::size_t stride) {
+            if constexpr (vectorized) {
+                using simd = std::experimental::native_simd<Group>;
+                constexpr std::size_t width = simd::size(), lanes = std::min<std::size_t>(2, block / width), rows = 4;
+                static_assert(block % (width * lanes) == 0);
+                for (std::size_t i = 0; i < block; i += rows) {
+                    for (std::size_t j = 0; j < block; j += width * lanes) {
+                        std::array<std::array<simd, lanes>, rows> tile;
+                        for (std::size_t r = 0; r < rows; ++r) {
+                            for (std::size_t l = 0; l < lanes; ++l) {
+                                tile[r][l].copy_from(target + (i + r) * stride + j + l * width, std::experimental::element_aligned);
+                            }
+                        }
+                        for (std::size_t k = 0; k < block; ++k) {
+                            std::array<simd, lanes> from;
+                            for (std::size_t l = 0; l < lanes; ++l) {
+                                from[l].copy_from(right + k * stride + j + l * width, std::experimental::element_aligned);
+                            }
+                            for (std::size_t r = 0; r < rows; ++r) {
+                                simd through = left[(i + r) * stride + k];
+                                for (std::size_t l = 0; l < lanes; ++l) {
+                                    tile[r][l] = std::experimental::min(tile[r][l], through + from[l]);
+                                }
+                            }
+                        }
+                        for (std::size_t r = 0; r < rows; ++r) {
+                            for (std::size_t l = 0; l < lanes; ++l) {
+                                tile[r][l].copy_to(target + (i + r) * stride + j + l * width, std::experimental::element_aligned);
+                            }
+                        }
+                    }
+                }
+            } else {
+                for (std::size_t i = 0; i < block; ++i) {
+                    for (std::size_t k = 0; k < block; ++k) {
+                        relax_row(target + i * stride, right + k * stride, left[i * stride + k]);
+                    }
+                }
+            }
+        }
+
+        static void parallel(std::size_t count, std::size_t threads, auto &&call) {
+            if (threads <= 1) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    call(i);
+                }
+                return;
+            }
+            std::atomic<std::size_t> next{};
+            std::vector<std::jthread> pool;
+            for (std::size_t t = 0; t < std::min(threads, count); ++t) {
+                pool.emplace_back([&] {
+                    for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                        call(i);
+                    }
+                });
+            }
+        }
     };
-}
+}
\ No newline at end of file
@@ -1,16 +1,59 @@
 /**
  * @brief Floyd-Warshall传递闭包算法
- * @details 使用bitset优化的传递闭包实现，用于判断图中任意两点间的可达性
- *          适用于稠密图的传递闭包计算
- * @complexity O(V^3 / w), 其中V为顶点数，w为机器字长
+ * @details 用于判断图中任意两点间的可达性，邻接关系以bitset矩阵存储
+ *          closure先用Tarjan::Graph把强连通分量缩成点，Tarjan给出的分量编号恰为逆拓扑序，后继分量的编号总比自身小
+ *          按编号从小到大，每个分量的可达集合等于各后继分量的可达集合之并，存放在按64字节对齐的扁平位矩阵中，每行只用到前缀
+ *          后继按编号从大到小合并，已被覆盖的后继直接跳过；同一层（到汇点的最长距离相同）的分量互不依赖，可以多线程并行
+ *          使用示例：FloydWarshall::Graph adj(n); adj.add_edge(u, v); auto closure = adj.closure(); closure.reachable(u, v);
+ * @complexity 缩点: O(V^2 / w + E); 传递闭包: O(V + C * E' / w), 其中C为分量数，E'为缩点后的边数，w为机器字长
  */
 #pragma once
 #include <tr2/dynamic_bitset>
+#include <bit>
+#include <array>
+#include <atomic>
+#include <thread>
 #include <vector>
+#include <barrier>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include "Tarjan.hpp"
 namespace FloydWarshall {
     /* Floyd Warshall Algorithm 传递闭包 */
     class Graph {
     public:
+        // 缩点后的可达矩阵, 第c行第d位表示分量c能否到达分量d
+        struct Closure {
+            struct alignas(64) line {
+                std::array<std::uint64_t, 8> word;
+            };
+
+            std::vector<std::uint32_t> component;
+            std::size_t stride;
+            std::vector<line> matrix;
+
+            std::size_t components() const {
+                return stride == 0 ? 0 : matrix.size() / stride;
+            }
+
+            // 分量c的行, 只有前c / 64 + 1个字可能非零
+            const std::uint64_t *row(std::size_t c) const {
+                return matrix[c * stride].word.data();
+            }
+
+            std::uint64_t *row(std::size_t c) {
+                return matrix[c * stride].word.data();
+            }
+
+            bool reachable(std::size_t u, std::size_t v) const {
+                auto d = component[v];
+                return row(component[u])[d >> 6] >> (d & 63) & 1;
+            }
+        };
+
         Graph(std::size_t vertex) : adj(vertex, std::tr2::dynamic_bitset<>(vertex)) {}
 
         void add_edge(std::size_t u, std::size_t v) {
@@ -30,19 +73,131 @@ namespace FloydWarshall {
             return adj[i];
         }
 
-        [[nodiscard]] std::vector<std::tr2::dynamic_bitset<>> solve() const {
-            auto res = adj;
-            for (std::size_t k = 0; k != adj.size(); ++k) {
-                for (std::size_t i = 0; i != adj.size(); ++i) {
-                    if (res[i][k]) {
-                        res[i] |= res[k];
+        // 与原先的逐行Floyd结果一致, i能到达i当且仅当i在某个环上
+        [[nodiscard]] std::vector<std::tr2::dynamic_bitset<>> solve(std::size_t threads = 1) const {
+            auto closure = this->closure(threads);
+            auto count = closure.components();
+            auto [offset, members] = group(closure.component, count);
+
+            std::vector<std::tr2::dynamic_bitset<>> res(adj.size());
+            for (std::size_t c = 0; c < count; ++c) {
+                std::tr2::dynamic_bitset<> current(adj.size());
+                auto row = closure.row(c);
+                for (std::size_t w = 0; w <= c >> 6; ++w) {
+                    for (auto word = row[w]; word != 0; word &= word - 1) {
+                        auto d = w << 6 | std::countr_zero(word);
+                        for (auto k = offset[d]; k < offset[d + 1]; ++k) {
+                            current.set(members[k]);
+                        }
+                    }
+                }
+                for (auto k = offset[c]; k < offset[c + 1]; ++k) {
+                    res[members[k]] = current;
+                }
+            }
+            return res;
+        }
+
+        [[nodiscard]] Closure closure(std::size_t threads = 1) const {
+            std::size_t n = adj.size();
+            Tarjan::Graph graph(n);
+            std::vector<bool> loop(n);
+            std::size_t edges = 0;
+            for (const auto &line : adj) {
+                edges += line.count();
+            }
+            graph.reserve(edges);
+            for (std::size_t i = 0; i < n; ++i) {
+                for (auto j = adj[i].find_first(); j < n; j = adj[i].find_next(j)) {
+                    graph.add_edge(i, j);
+                }
+                loop[i] = adj[i][i];
+            }
+
+            // Tarjan给出的分量编号即逆拓扑序, 缩点后每个分量的后继按编号升序排列
+            auto scc = graph.solve();
+            auto count = static_cast<std::uint32_t>(scc.count);
+            auto [dag_offset, dag_to] = graph.condensation(scc);
+            Closure res{std::move(scc.component), 0, {}};
+            std::vector<std::uint32_t> size(count);
+            std::vector<bool> cyclic(count);
+            for (std::size_t v = 0; v < n; ++v) {
+                auto c = res.component[v];
+                ++size[c];
+                cyclic[c] = cyclic[c] or loop[v];
+            }
+            for (std::uint32_t c = 0; c < count; ++c) {
+                cyclic[c] = cyclic[c] or size[c] > 1;
+            }
+
+            res.stride = (count + 511) / 512;
+            res.matrix.resize(res.stride * count);
+            auto propagate = [&](std::uint32_t c) {
+                auto row = res.row(c);
+                if (cyclic[c]) {
+                    row[c >> 6] |= std::uint64_t(1) << (c & 63);
+                }
+                for (auto e = dag_offset[c + 1]; e-- > dag_offset[c];) {
+                    auto d = dag_to[e];
+                    if (row[d >> 6] >> (d & 63) & 1) {
+                        continue;
+                    }
+                    row[d >> 6] |= std::uint64_t(1) << (d & 63);
+                    auto from = std::as_const(res).row(d);
+                    for (std::size_t w = 0; w <= d >> 6; ++w) {
+                        row[w] |= from[w];
                     }
                 }
+            };
+            threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(count, 1));
+            if (threads == 1) {
+                for (std::uint32_t c = 0; c < count; ++c) {
+                    propagate(c);
+                }
+                return res;
             }
+
+            // 按到汇点的最长距离分层, 层内并行, 层间用barrier同步
+            std::vector<std::uint32_t> level(count);
+            for (std::uint32_t c = 0; c < count; ++c) {
+                for (auto e = dag_offset[c]; e < dag_offset[c + 1]; ++e) {
+                    level[c] = std::max(level[c], level[dag_to[e]] + 1);
+                }
+            }
+            auto [level_offset, sorted] = group(level, *std::max_element(level.begin(), level.end()) + 1);
+
+            std::vector<std::atomic<std::uint32_t>> cursors(level_offset.size() - 1);
+            std::barrier sync(threads);
+            auto worker = [&]() {
+                for (std::size_t l = 0; l + 1 < level_offset.size(); ++l) {
+                    for (std::uint32_t k; (k = level_offset[l] + cursors[l].fetch_add(1, std::memory_order_relaxed)) < level_offset[l + 1];) {
+                        propagate(sorted[k]);
+                    }
+                    sync.arrive_and_wait();
+                }
+            };
+            std::vector<std::jthread> pool;
+            for (std::size_t i = 1; i < threads; ++i) {
+                pool.emplace_back(worker);
+            }
+            worker();
             return res;
         }
 
     private:
         std::vector<std::tr2::dynamic_bitset<>> adj;
+        // 按分量计数排序, 分量c的点为members[offset[c], offset[c + 1])
+        static std::pair<std::vector<std::uint32_t>, std::vector<std::uint32_t>> group(const std::vector<std::uint32_t> &component, std::size_t count) {
+            std::vector<std::uint32_t> offset(count + 1), members(component.size());
+            for (auto c : component) {
+                ++offset[c + 1];
+            }
+            std::partial_sum(offset.begin(), offset.end(), offset.begin());
+            auto fill = offset;
+            for (std::uint32_t i = 0; i < component.size(); ++i) {
+                members[fill[component[i]]++] = i;
+            }
+            return {offset, members};
+        }
     };
 }
\ No newline at end of file
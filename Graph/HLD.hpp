@@ -0,0 +1,236 @@
+/**
+ * @brief 重链剖分（Heavy-Light Decomposition）
+ * @details 边先存入边表，build(root)时由LCA::Rooted转为32位下标的CSR并迭代DFS求出父亲与深度，然后求出子树大小与重儿子，按重儿子优先的先序为每个点分配位置
+ *          同一条重链上的点位置连续且链顶最小，每棵子树占据区间[position(v), position(v) + size(v) - 1]
+ *          树上路径被拆成O(log n)段闭区间，path_prod、path_apply和subtree_prod直接转发给按position排布的SegmentTree/LazySegmentTree
+ *          只传一棵树时path_prod要求op满足交换律，在编译期检查：std::plus<>、std::multiplies<>、std::bit_and<>/bit_or<>/bit_xor<>、std::ranges::min/max已标记
+ *          其他满足交换律的op（如lambda或自定义函数）有两种写法：调用处显式声明tree.path_prod<true>(seg, u, v)，
+ *          或在全局作用域特化一次template <> constexpr bool HLD::commutative<add> = true;（add为传给SegmentTree的op）
+ *          op不满足交换律（矩阵、哈希等）时另传一棵以op(b, a)为运算的reversed树，u一侧各段取其自下而上的积，结果严格按u到v的顺序
+ *          edge为true时按边权处理：边(parent(v), v)的权值存在v的位置上，路径上不计LCA本身
+ *          使用示例：HLD::Tree tree(n); tree.add_edge(u, v); tree.build(root); SegmentTree<int, op, e> seg(tree.layout(value));
+ *                    tree.path_prod(seg, u, v); tree.path_prod(seg, reversed, u, v); tree.path_apply(lazy, u, v, f); tree.subtree_prod(seg, v); seg.set(tree.position(v), x);
+ * @complexity 预处理: O(n); LCA: O(log n); 路径查询/修改: O(log^2 n); 子树查询/修改: O(log n)
+ */
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "LCA.hpp"
+#include "../DS/SegmentTree.hpp"
+#include "../DS/LazySegmentTree.hpp"
+namespace HLD {
+    // 标记op是否满足交换律, 只有满足时path_prod才能只用一棵线段树; 自定义的运算可特化, 或在调用时写path_prod<true>
+    template <auto op>
+    constexpr bool commutative = []() {
+        using type = std::remove_cvref_t<decltype(op)>;
+        return std::is_same_v<type, std::plus<>> or std::is_same_v<type, std::multiplies<>> or std::is_same_v<type, std::bit_and<>> or std::is_same_v<type, std::bit_or<>> or std::is_same_v<type, std::bit_xor<>> or std::is_same_v<type, std::remove_cvref_t<decltype(std::ranges::min)>> or std::is_same_v<type, std::remove_cvref_t<decltype(std::ranges::max)>>;
+    }();
+
+    class Tree {
+    public:
+        Tree(std::size_t vertex) : n(vertex) {}
+
+        void add_edge(std::size_t u, std::size_t v) {
+            edges.emplace_back(u, v);
+        }
+
+        void reserve(std::size_t edge) {
+            edges.reserve(edge);
+        }
+
+        std::size_t size() const {
+            return n;
+        }
+
+        void resize(std::size_t vertex) {
+            n = vertex;
+            edges.clear();
+        }
+
+        // 以root为根剖分, 只处理与root连通的点
+        void build(std::size_t root = 0) {
+            LCA::Rooted tree(n, edges, root);
+            const auto &offset = tree.offset, &to = tree.to, &order = tree.order;
+            _parent = std::move(tree.parent);
+            _depth = std::move(tree.depth);
+            _size.assign(n, 1);
+            std::vector<std::uint32_t> stack, heavy(n, n);
+            for (auto k = order.size(); k-- > 1;) {
+                auto v = order[k], p = _parent[v];
+                _size[p] += _size[v];
+                if (heavy[p] == n or _size[heavy[p]] < _size[v]) {
+                    heavy[p] = v;
+                }
+            }
+
+            // 重儿子最后入栈、最先出栈, 因此紧跟在父亲之后, 整条重链的位置连续
+            _position.assign(n, 0);
+            head.assign(n, root);
+            std::uint32_t timer = 0;
+            stack.assign(1, root);
+            while (not stack.empty()) {
+                auto u = stack.back();
+                stack.pop_back();
+                _position[u] = timer++;
+                for (auto e = offset[u]; e < offset[u + 1]; ++e) {
+                    if (auto v = to[e]; v != _parent[u] and v != heavy[u]) {
+                        head[v] = v;
+                        stack.push_back(v);
+                    }
+                }
+                if (heavy[u] != n) {
+                    head[heavy[u]] = head[u];
+                    stack.push_back(heavy[u]);
+                }
+            }
+        }
+
+        std::size_t parent(std::size_t v) const {
+            return _parent[v];
+        }
+
+        std::size_t depth(std::size_t v) const {
+            return _depth[v];
+        }
+
+        // 子树大小
+        std::size_t size(std::size_t v) const {
+            return _size[v];
+        }
+
+        // v在线段树中的下标
+        std::size_t position(std::size_t v) const {
+            return _position[v];
+        }
+
+        // 把按点编号给出的初值重排为线段树的初始数组
+        template <typename T>
+        [[nodiscard]] std::vector<T> layout(const std::vector<T> &value) const {
+            std::vector<T> res(value.size());
+            for (std::size_t v = 0; v < n; ++v) {
+                res[_position[v]] = value[v];
+            }
+            return res;
+        }
+
+        std::size_t lca(std::size_t u, std::size_t v) const {
+            for (; head[u] != head[v]; u = _parent[head[u]]) {
+                if (_depth[head[u]] < _depth[head[v]]) {
+                    std::swap(u, v);
+                }
+            }
+            return _depth[u] < _depth[v] ? u : v;
+        }
+
+        std::size_t distance(std::size_t u, std::size_t v) const {
+            return _depth[u] + _depth[v] - 2 * _depth[lca(u, v)];
+        }
+
+        // 对u到v路径拆出的每段闭区间[l, r]调用call(l, r), 共O(log n)段
+        void for_each_path(std::size_t u, std::size_t v, bool edge, auto &&call) const {
+            for (; head[u] != head[v]; u = _parent[head[u]]) {
+                if (_depth[head[u]] < _depth[head[v]]) {
+                    std::swap(u, v);
+                }
+                call(_position[head[u]], _position[u]);
+            }
+            if (_depth[u] > _depth[v]) {
+                std::swap(u, v);
+            }
+            if (_position[u] + edge <= _position[v]) {
+                call(_position[u] + edge, _position[v]);
+            }
+        }
+
+        // 只用一棵树时要求op满足交换律: commutative<op>为真, 或调用者以Commutative = true声明, 否则编译失败
+        template <bool Commutative = false, typename Info, auto op, auto e>
+        Info path_prod(const SegmentTree<Info, op, e> &tree, std::size_t u, std::size_t v, bool edge = false) const {
+            static_assert(Commutative or commutative<op>, "path_prod with a single tree needs a commutative op: call path_prod<true>, specialize HLD::commutative, or pass a reversed tree");
+            auto prod = [&](std::size_t l, std::size_t r) {
+                return tree.prod(l, r);
+            };
+            return fold<op>(u, v, edge, e(), prod, prod);
+        }
+
+        template <bool Commutative = false, typename Info, typename Function, auto Mapping, auto Composition, auto op, auto e, auto id>
+        Info path_prod(LazySegmentTree<Info, Function, Mapping, Composition, op, e, id> &tree, std::size_t u, std::size_t v, bool edge = false) const {
+            static_assert(Commutative or commutative<op>, "path_prod with a single tree needs a commutative op: call path_prod<true>, specialize HLD::commutative, or pass a reversed tree");
+            auto prod = [&](std::size_t l, std::size_t r) {
+                return tree.prod(l, r);
+            };
+            return fold<op>(u, v, edge, e(), prod, prod);
+        }
+
+        // 按u到v的顺序求积, reversed为以op(b, a)为运算、按同一layout建立的线段树, 给出u一侧各段自下而上的积
+        template <typename Info, auto op, auto e, auto reversed_op, auto reversed_e>
+        Info path_prod(const SegmentTree<Info, op, e> &tree, const SegmentTree<Info, reversed_op, reversed_e> &reversed, std::size_t u, std::size_t v, bool edge = false) const {
+            return fold<op>(u, v, edge, e(), [&](std::size_t l, std::size_t r) {
+                return tree.prod(l, r);
+            }, [&](std::size_t l, std::size_t r) {
+                return reversed.prod(l, r);
+            });
+        }
+
+        // 同上, 修改时需对两棵树分别path_apply
+        template <typename Info, typename Function, auto Mapping, auto Composition, auto op, auto e, auto id, typename ReversedFunction, auto ReversedMapping, auto ReversedComposition, auto reversed_op, auto reversed_e, auto reversed_id>
+        Info path_prod(LazySegmentTree<Info, Function, Mapping, Composition, op, e, id> &tree, LazySegmentTree<Info, ReversedFunction, ReversedMapping, ReversedComposition, reversed_op, reversed_e, reversed_id> &reversed, std::size_t u, std::size_t v, bool edge = false) const {
+            return fold<op>(u, v, edge, e(), [&](std::size_t l, std::size_t r) {
+                return tree.prod(l, r);
+            }, [&](std::size_t l, std::size_t r) {
+                return reversed.prod(l, r);
+            });
+        }
+
+        template <typename Info, typename Function, auto Mapping, auto Composition, auto op, auto e, auto id>
+        void path_apply(LazySegmentTree<Info, Function, Mapping, Composition, op, e, id> &tree, std::size_t u, std::size_t v, std::type_identity_t<Function> function, bool edge = false) const {
+            for_each_path(u, v, edge, [&](std::size_t l, std::size_t r) {
+                tree.apply(l, r, function);
+            });
+        }
+
+        template <typename Info, auto op, auto e>
+        Info subtree_prod(const SegmentTree<Info, op, e> &tree, std::size_t v) const {
+            return tree.prod(_position[v], _position[v] + _size[v] - 1);
+        }
+
+        template <typename Info, typename Function, auto Mapping, auto Composition, auto op, auto e, auto id>
+        Info subtree_prod(LazySegmentTree<Info, Function, Mapping, Composition, op, e, id> &tree, std::size_t v) const {
+            return tree.prod(_position[v], _position[v] + _size[v] - 1);
+        }
+
+        template <typename Info, typename Function, auto Mapping, auto Composition, auto op, auto e, auto id>
+        void subtree_apply(LazySegmentTree<Info, Function, Mapping, Composition, op, e, id> &tree, std::size_t v, std::type_identity_t<Function> function) const {
+            tree.apply(_position[v], _position[v] + _size[v] - 1, function);
+        }
+
+    private:
+        std::size_t n;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+        std::vector<std::uint32_t> _parent, _depth, _size, _position, head;
+        // left为u一侧自下而上的积, right为v一侧自上而下的积, 答案为op(left, right)
+        template <auto op, typename Info>
+        Info fold(std::size_t u, std::size_t v, bool edge, Info e, auto &&forward, auto &&backward) const {
+            Info left = e, right = e;
+            while (head[u] != head[v]) {
+                if (_depth[head[u]] >= _depth[head[v]]) {
+                    left = op(left, backward(_position[head[u]], _position[u]));
+                    u = _parent[head[u]];
+                } else {
+                    right = op(forward(_position[head[v]], _position[v]), right);
+                    v = _parent[head[v]];
+                }
+            }
+            if (_depth[u] >= _depth[v]) {
+                if (_position[v] + edge <= _position[u]) {
+                    left = op(left, backward(_position[v] + edge, _position[u]));
+                }
+            } else if (_position[u] + edge <= _position[v]) {
+                right = op(forward(_position[u] + edge, _position[v]), right);
+            }
+            return op(left, right);
+        }
+    };
+}
\ No newline at end of file
@@ -2,13 +2,30 @@
  * @brief 匈牙利算法（Hungarian Algorithm）
  * @details 用于求解二分图最大匹配问题，返回最大匹配数和匹配方案
  *          max为最大匹配数，left_info和right_info分别为左右两侧的匹配信息
- * @complexity O(V * E), 其中V为顶点数，E为边数
+ *          solve为Kuhn算法：先按随机顺序贪心匹配，再分若干遍增广，每一遍共用一个时间戳作访问标记，无需清空
+ *          hopcroft_karp在32位下标的CSR副本上运行：每轮BFS从所有未匹配左点分层，再沿层次用迭代DFS找一组点不相交的最短增广路
+ *          Assignment为带权版本（Kuhn-Munkres），在行优先的稠密代价矩阵上用行列势能求最小权匹配，求最大权时把代价取反即可
+ *          使用示例：Hungarian::Graph adj(n); adj.add_edge(l, r); auto [max, left_info, right_info] = adj.hopcroft_karp();
+ *                    Hungarian::Assignment<i64> a(n, m); a(i, j) = cost; auto [cost, left_info, right_info] = a.solve();
+ * @complexity solve: O(V * E); hopcroft_karp: O(E * sqrt(V)), 其中V为顶点数，E为边数; Assignment: O(n^2 * m), 其中n <= m为矩阵的两维
  */
 #pragma once
+#include <tuple>
+#include <limits>
+#include <random>
 #include <vector>
-#include <tr2/dynamic_bitset>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <algorithm>
 namespace Hungarian {
     constexpr std::size_t none = -1;
+    struct info {
+        std::size_t max;
+        std::vector<std::size_t> left_info;
+        std::vector<std::size_t> right_info;
+    };
+
     class Graph {
     public:
         Graph(std::size_t vertex) : adj(vertex) {}
@@ -30,18 +47,36 @@ namespace Hungarian {
             return adj[index];
         }
 
-        [[nodiscard]] auto solve() const {
+        // 先贪心匹配再按随机顺序增广, seed固定时结果确定
+        [[nodiscard]] info solve(std::uint32_t seed = 0) const {
             std::size_t max = 0;
-            std::tr2::dynamic_bitset<> visited(adj.size());
+            std::vector<std::uint32_t> visited(adj.size());
             std::vector<std::size_t> left_info(adj.size(), none);
             std::vector<std::size_t> right_info(adj.size(), none);
+            std::vector<std::size_t> order(adj.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), std::mt19937(seed));
 
+            for (auto left : order) {
+                for (const auto &right : adj[left]) {
+                    if (right_info[right] == none) {
+                        right_info[right] = left;
+                        left_info[left] = right;
+                        ++max;
+                        break;
+                    }
+                }
+            }
+
+            // 每一遍对所有未匹配左点各增广一次, 遍内共用一个时间戳, 某一遍没有任何增广时即为最大匹配
+            std::uint32_t epoch = 0;
             auto match = [&](auto &&self, std::size_t left) -> bool {
                 for (const auto &right : adj[left]) {
-                    if (not visited.test(right)) {
-                        visited.set(right);
+                    if (visited[right] != epoch) {
+                        visited[right] = epoch;
                         if (auto &matching = right_info[right]; matching == none or self(self, matching)) {
                             matching = left;
+                            left_info[left] = right;
                             return true;
                         }
                     }
@@ -49,28 +84,227 @@ namespace Hungarian {
                 return false;
             };
 
-            for (std::size_t left = 0; left < adj.size(); ++left) {
-                visited.reset();
-                max += match(match, left);
+            for (bool augmented = true; augmented;) {
+                augmented = false;
+                ++epoch;
+                for (auto left : order) {
+                    if (left_info[left] == none and match(match, left)) {
+                        ++max;
+                        augmented = true;
+                    }
+                }
             }
 
-            for (std::size_t left = 0; left < adj.size(); ++left) {
-                if (right_info[left] == none) {
-                    continue;
-                }
-                left_info[right_info[left]] = left;
+            return info{.max = max, .left_info = left_info, .right_info = right_info};
+        }
+
+        [[nodiscard]] info hopcroft_karp() const {
+            constexpr auto invalid = std::numeric_limits<std::uint32_t>::max();
+            std::size_t n = adj.size(), max = 0;
+            std::vector<std::uint32_t> offset(n + 1), to;
+            for (std::size_t i = 0; i < n; ++i) {
+                offset[i + 1] = offset[i] + adj[i].size();
             }
+            to.reserve(offset[n]);
+            for (const auto &list : adj) {
+                to.insert(to.end(), list.begin(), list.end());
+            }
+
+            std::vector<std::uint32_t> match_left(n, invalid), match_right(n, invalid), distance(n), cursor(n), queue, path;
+            queue.reserve(n);
+            // 分层后limit为最短增广路上最后一个左点的层数, 不存在增广路时返回false
+            auto bfs = [&]() {
+                auto limit = invalid;
+                queue.clear();
+                for (std::uint32_t left = 0; left < n; ++left) {
+                    distance[left] = match_left[left] == invalid ? 0 : invalid;
+                    if (distance[left] == 0) {
+                        queue.push_back(left);
+                    }
+                }
+                for (std::size_t head = 0; head < queue.size(); ++head) {
+                    auto left = queue[head];
+                    if (distance[left] >= limit) {
+                        break;
+                    }
+                    for (auto e = offset[left]; e < offset[left + 1]; ++e) {
+                        if (auto next = match_right[to[e]]; next == invalid) {
+                            limit = distance[left];
+                        } else if (distance[next] == invalid) {
+                            distance[next] = distance[left] + 1;
+                            queue.push_back(next);
+                        }
+                    }
+                }
+                return std::pair{limit != invalid, limit};
+            };
 
-            struct info {
-                std::size_t max;
-                std::vector<std::size_t> left_info;
-                std::vector<std::size_t> right_info;
+            // path中每个左点的cursor指向它在增广路上要匹配的右点, 失败的点把层数置为invalid, 本轮不再访问
+            auto dfs = [&](std::uint32_t source, std::uint32_t limit) {
+                path.assign(1, source);
+                while (not path.empty()) {
+                    auto left = path.back();
+                    if (cursor[left] == offset[left + 1]) {
+                        distance[left] = invalid;
+                        path.pop_back();
+                        if (not path.empty()) {
+                            ++cursor[path.back()];
+                        }
+                        continue;
+                    }
+                    auto right = to[cursor[left]];
+                    if (auto next = match_right[right]; next == invalid) {
+                        if (distance[left] == limit) {
+                            for (auto vertex : path) {
+                                auto target = to[cursor[vertex]];
+                                match_left[vertex] = target;
+                                match_right[target] = vertex;
+                                distance[vertex] = invalid;
+                            }
+                            return true;
+                        }
+                        ++cursor[left];
+                    } else if (distance[next] == distance[left] + 1) {
+                        path.push_back(next);
+                    } else {
+                        ++cursor[left];
+                    }
+                }
+                return false;
             };
 
+            for (auto [found, limit] = bfs(); found; std::tie(found, limit) = bfs()) {
+                std::copy(offset.begin(), offset.end() - 1, cursor.begin());
+                for (std::uint32_t left = 0; left < n; ++left) {
+                    if (match_left[left] == invalid and distance[left] == 0) {
+                        max += dfs(left, limit);
+                    }
+                }
+            }
+
+            std::vector<std::size_t> left_info(n, none), right_info(n, none);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (match_left[i] != invalid) {
+                    left_info[i] = match_left[i];
+                }
+                if (match_right[i] != invalid) {
+                    right_info[i] = match_right[i];
+                }
+            }
             return info{.max = max, .left_info = left_info, .right_info = right_info};
         }
 
     private:
         std::vector<std::vector<std::size_t>> adj;
     };
+
+    template <typename T>
+    struct weighted_info {
+        T cost;
+        std::vector<std::size_t> left_info;
+        std::vector<std::size_t> right_info;
+    };
+
+    /* Kuhn-Munkres 最小权完美匹配 */
+    template <typename T>
+    class Assignment {
+    public:
+        Assignment(std::size_t rows, std::size_t columns, const T &cost = T{}) : _rows(rows), _columns(columns), matrix(rows * columns, cost) {}
+
+        std::size_t rows() const {
+            return _rows;
+        }
+
+        std::size_t columns() const {
+            return _columns;
+        }
+
+        T &operator()(std::size_t row, std::size_t column) {
+            return matrix[row * _columns + column];
+        }
+
+        const T &operator()(std::size_t row, std::size_t column) const {
+            return matrix[row * _columns + column];
+        }
+
+        // 行数多于列数时在转置矩阵上求解, 保证每一行(或每一列)都被匹配
+        [[nodiscard]] weighted_info<T> solve() const {
+            if (_rows <= _columns) {
+                return solve(matrix.data(), _rows, _columns);
+            }
+            std::vector<T> transposed(matrix.size());
+            for (std::size_t i = 0; i < _rows; ++i) {
+                for (std::size_t j = 0; j < _columns; ++j) {
+                    transposed[j * _rows + i] = matrix[i * _columns + j];
+                }
+            }
+            auto res = solve(transposed.data(), _columns, _rows);
+            std::swap(res.left_info, res.right_info);
+            return res;
+        }
+
+    private:
+        std::size_t _rows, _columns;
+        std::vector<T> matrix;
+        // 逐行加入, 从虚拟列m出发按约简代价做Dijkstra, distance[j]为列j的最短距离, 到达未匹配的列后沿way回溯增广
+        // 势能只在一轮结束时对树上的列和行修改一次, 等价于每扩展一步都整体修改
+        static weighted_info<T> solve(const T *cost, std::size_t n, std::size_t m) {
+            constexpr T infinity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+            std::vector<T> u(n), v(m + 1), distance(m + 1);
+            std::vector<std::size_t> match(m + 1, none), way(m + 1), rest(m), tree;
+            tree.reserve(m + 1);
+            for (std::size_t i = 0; i < n; ++i) {
+                match[m] = i;
+                std::size_t column = m;
+                std::fill(distance.begin(), distance.end(), infinity);
+                std::iota(rest.begin(), rest.end(), 0);
+                distance[m] = T{};
+                tree.clear();
+                for (std::size_t size = m;;) {
+                    tree.push_back(column);
+                    auto row = match[column];
+                    auto line = cost + row * m;
+                    auto base = distance[column] - u[row];
+                    T shortest = infinity;
+                    std::size_t position = 0;
+                    for (std::size_t k = 0; k < size; ++k) {
+                        auto j = rest[k];
+                        if (T current = base + line[j] - v[j]; current < distance[j]) {
+                            distance[j] = current;
+                            way[j] = column;
+                        }
+                        if (distance[j] < shortest) {
+                            shortest = distance[j];
+                            position = k;
+                        }
+                    }
+                    column = rest[position];
+                    rest[position] = rest[--size];
+                    if (match[column] == none) {
+                        break;
+                    }
+                }
+                for (auto j : tree) {
+                    auto delta = distance[column] - distance[j];
+                    u[match[j]] += delta;
+                    v[j] -= delta;
+                }
+                do {
+                    auto previous = way[column];
+                    match[column] = match[previous];
+                    column = previous;
+                } while (column != m);
+            }
+
+            weighted_info<T> res{T{}, std::vector<std::size_t>(n, none), std::vector<std::size_t>(m, none)};
+            for (std::size_t j = 0; j < m; ++j) {
+                if (auto row = match[j]; row != none) {
+                    res.left_info[row] = j;
+                    res.right_info[j] = row;
+                    res.cost += cost[row * m + j];
+                }
+            }
+            return res;
+        }
+    };
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * @brief 最近公共祖先（Lowest Common Ancestor）
+ * @details 边先存入边表，build(root)时由Rooted转为32位下标的CSR，用显式栈做迭代DFS得到先序、父亲与深度，没有递归深度限制
+ *          query为欧拉序RMQ的先序写法：对dfn[u] < dfn[v]，LCA是先序区间(dfn[u], dfn[v]]中深度最小的点的父亲，
+ *          因此只需在长为n的数组上建SparseTable（而不是长为2n - 1的欧拉序），存父亲的先序编号，取最小值即得答案
+ *          lift()另建倍增表作为后备，层数只取到树高的位宽，额外支持ancestor(v, k)求k级祖先；build(root, false)可省去SparseTable的内存
+ *          offline为Tarjan离线算法：询问按端点计数排序并带上另一端点，按先序扫描，离开子树时把它并入父亲，对已扫描过的另一端点做一次查找
+ *          使用示例：LCA::Tree tree(n); tree.add_edge(u, v); tree.build(root); tree.query(u, v); tree.distance(u, v);
+ *                    auto answer = tree.offline(queries); tree.lift(); tree.ancestor(v, k);
+ * @complexity 预处理: O(n log n); query: O(1); 倍增: O(n log h)预处理, O(log h)查询, 其中h为树高; offline: O((n + q) α(n)), 其中q为询问数
+ */
+#pragma once
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "../DS/SparseTable.hpp"
+namespace LCA {
+    // 无向树的32位下标CSR, 以及以root为根迭代DFS得到的先序、父亲与深度, 只含与root连通的点; LCA::Tree与HLD::Tree共用
+    struct Rooted {
+        std::vector<std::uint32_t> offset, to, parent, depth, order;
+
+        Rooted(std::size_t n, const std::vector<std::pair<std::uint32_t, std::uint32_t>> &edges, std::size_t root) : offset(n + 1), to(2 * edges.size()), parent(n, root), depth(n) {
+            for (const auto &[u, v] : edges) {
+                ++offset[u + 1];
+                ++offset[v + 1];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                offset[i + 1] += offset[i];
+            }
+            auto fill = offset;
+            for (const auto &[u, v] : edges) {
+                to[fill[u]++] = v;
+                to[fill[v]++] = u;
+            }
+
+            order.reserve(n);
+            std::vector<std::uint32_t> stack{static_cast<std::uint32_t>(root)};
+            while (not stack.empty()) {
+                auto u = stack.back();
+                stack.pop_back();
+                order.push_back(u);
+                for (auto e = offset[u]; e < offset[u + 1]; ++e) {
+                    if (auto v = to[e]; v != parent[u]) {
+                        parent[v] = u;
+                        depth[v] = depth[u] + 1;
+                        stack.push_back(v);
+                    }
+                }
+            }
+        }
+    };
+
+    class Tree {
+    public:
+        Tree(std::size_t vertex) : n(vertex), sparse(0) {}
+
+        void add_edge(std::size_t u, std::size_t v) {
+            edges.emplace_back(u, v);
+        }
+
+        void reserve(std::size_t edge) {
+            edges.reserve(edge);
+        }
+
+        std::size_t size() const {
+            return n;
+        }
+
+        void resize(std::size_t vertex) {
+            n = vertex;
+            edges.clear();
+        }
+
+        // 以root为根建树, 只处理与root连通的点; sparse为false时不建SparseTable, 之后只能使用lift()或offline
+        void build(std::size_t root = 0, bool sparse = true) {
+            Rooted tree(n, edges, root);
+            _parent = std::move(tree.parent);
+            _depth = std::move(tree.depth);
+            order = std::move(tree.order);
+            dfn.assign(n, 0);
+            for (std::uint32_t i = 0; i < order.size(); ++i) {
+                dfn[order[i]] = i;
+            }
+            jump.clear();
+
+            this->sparse = decltype(this->sparse)(sparse ? order.size() : 0, [&](std::size_t i) {
+                return dfn[_parent[order[i]]];
+            });
+        }
+
+        std::size_t parent(std::size_t v) const {
+            return _parent[v];
+        }
+
+        std::size_t depth(std::size_t v) const {
+            return _depth[v];
+        }
+
+        std::size_t query(std::size_t u, std::size_t v) const {
+            if (u == v) {
+                return u;
+            }
+            auto [l, r] = std::minmax(dfn[u], dfn[v]);
+            return order[sparse.query(l + 1, r)];
+        }
+
+        std::size_t distance(std::size_t u, std::size_t v) const {
+            return _depth[u] + _depth[v] - 2 * _depth[query(u, v)];
+        }
+
+        // 倍增表按层存放, jump[k * n + v]为v的2^k级祖先, 根的祖先仍为根
+        void lift() {
+            auto height = order.empty() ? 0 : *std::max_element(_depth.begin(), _depth.end());
+            levels = std::max<std::size_t>(std::bit_width(height), 1);
+            jump.resize(levels * n);
+            std::copy(_parent.begin(), _parent.end(), jump.begin());
+            for (std::size_t k = 1; k < levels; ++k) {
+                auto previous = jump.data() + (k - 1) * n, current = jump.data() + k * n;
+                for (std::size_t v = 0; v < n; ++v) {
+                    current[v] = previous[previous[v]];
+                }
+            }
+        }
+
+        // k级祖先, k超过深度时返回根, 需先lift()
+        std::size_t ancestor(std::size_t v, std::size_t k) const {
+            k = std::min<std::size_t>(k, _depth[v]);
+            for (std::size_t i = 0; k != 0; ++i, k >>= 1) {
+                if (k & 1) {
+                    v = jump[i * n + v];
+                }
+            }
+            return v;
+        }
+
+        // 倍增求LCA, 需先lift()
+        std::size_t lift_query(std::size_t u, std::size_t v) const {
+            if (_depth[u] < _depth[v]) {
+                std::swap(u, v);
+            }
+            u = ancestor(u, _depth[u] - _depth[v]);
+            if (u == v) {
+                return u;
+            }
+            for (auto k = levels; k-- > 0;) {
+                if (auto x = jump[k * n + u], y = jump[k * n + v]; x != y) {
+                    u = x;
+                    v = y;
+                }
+            }
+            return _parent[u];
+        }
+
+        // 离线回答一批询问, 第i个答案对应queries[i]
+        [[nodiscard]] std::vector<std::size_t> offline(const std::vector<std::pair<std::size_t, std::size_t>> &queries) const {
+            std::vector<std::uint32_t> offset(n + 1);
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> incident(2 * queries.size());
+            for (const auto &[u, v] : queries) {
+                ++offset[u + 1];
+                ++offset[v + 1];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                offset[i + 1] += offset[i];
+            }
+            auto fill = offset;
+            for (std::uint32_t i = 0; i < queries.size(); ++i) {
+                auto [u, v] = queries[i];
+                incident[fill[u]++] = {i, v};
+                incident[fill[v]++] = {i, u};
+            }
+
+            // link指向父亲的子树已扫描完毕, 沿link找到的第一个自指的点即仍在DFS栈上的最近祖先
+            std::vector<std::size_t> res(queries.size());
+            std::vector<std::uint32_t> link(n), path;
+            for (std::uint32_t i = 0; i < n; ++i) {
+                link[i] = i;
+            }
+            auto find = [&](std::uint32_t x) {
+                while (link[x] != x) {
+                    x = link[x] = link[link[x]];
+                }
+                return x;
+            };
+            for (auto x : order) {
+                while (not path.empty() and path.back() != _parent[x]) {
+                    link[path.back()] = _parent[path.back()];
+                    path.pop_back();
+                }
+                for (auto k = offset[x]; k < offset[x + 1]; ++k) {
+                    if (auto [i, y] = incident[k]; dfn[y] <= dfn[x]) {
+                        res[i] = find(y);
+                    }
+                }
+                path.push_back(x);
+            }
+            return res;
+        }
+
+    private:
+        std::size_t n, levels = 0;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+        std::vector<std::uint32_t> _parent, _depth, dfn, order, jump;
+        SparseTable<std::uint32_t, std::ranges::min, 32> sparse;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+/**
+ * @brief Tarjan强连通分量与2-SAT
+ * @details 边先存入边表，freeze()时按起点计数排序为32位下标的CSR，不为每个点单独分配邻接表，适合10^7级别的点数
+ *          solve()为迭代的Tarjan（Pearce的单数组写法），显式维护DFS路径与每个点的当前弧，没有递归深度限制
+ *          分量按出栈顺序编号，即逆拓扑序：若分量a有边指向分量b，则a > b
+ *          condensation(scc)返回缩点后的DAG，offset[c]到offset[c + 1]为分量c去重后按编号升序排列的后继
+ *          TwoSat在2n个文字上建图：2i表示x_i为真，2i + 1表示x_i为假；x_i取真当且仅当其真文字所在分量的编号更小（拓扑序更靠后）
+ *          使用示例：
+ *          - Tarjan::Graph g(n); g.add_edge(u, v); auto res = g.solve(); res.component[v]; auto [offset, to] = g.condensation(res);
+ *          - Tarjan::TwoSat sat(n); sat.add_clause(i, true, j, false); auto [satisfiable, answer] = sat.solve();
+ * @complexity O(V + E), 其中V为顶点数，E为边数
+ */
+#pragma once
+#include <span>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+namespace Tarjan {
+    constexpr auto invalid = std::numeric_limits<std::uint32_t>::max();
+
+    class Graph {
+    public:
+        struct info {
+            std::size_t count;
+            std::vector<std::uint32_t> component;
+        };
+
+        Graph(std::size_t vertex) : n(vertex), frozen(false) {}
+
+        void add_edge(std::size_t u, std::size_t v) {
+            frozen = false;
+            edges.emplace_back(u, v);
+        }
+
+        void reserve(std::size_t edge) {
+            edges.reserve(edge);
+        }
+
+        std::size_t size() const {
+            return n;
+        }
+
+        void resize(std::size_t vertex) {
+            frozen = false;
+            n = vertex;
+            edges.clear();
+        }
+
+        void freeze() {
+            offset.assign(n + 1, 0);
+            for (const auto &[u, v] : edges) {
+                ++offset[u + 1];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                offset[i + 1] += offset[i];
+            }
+            std::vector<std::uint32_t> fill(offset.begin(), offset.end() - 1);
+            to.resize(edges.size());
+            for (const auto &[u, v] : edges) {
+                to[fill[u]++] = v;
+            }
+            frozen = true;
+        }
+
+        // Pearce的单数组写法: rindex[v]依次充当DFS序、low值和最终的分量编号, 每条边只访问终点的一个数组
+        // 分量编号从n - 1向下分配, 总大于任何仍在栈中的点的DFS序, 因此已确定分量的点不会再更新low值
+        [[nodiscard]] info solve() {
+            if (not frozen) {
+                freeze();
+            }
+            std::vector<std::uint32_t> rindex(n, 0), cursor(offset.begin(), offset.end() - 1), stack, path;
+            std::vector<bool> root(n);
+            std::uint32_t index = 1, last = n - 1, label = last;
+            auto visit = [&](std::uint32_t v) {
+                rindex[v] = index++;
+                root[v] = true;
+                path.push_back(v);
+            };
+            for (std::uint32_t source = 0; source < n; ++source) {
+                if (rindex[source] != 0) {
+                    continue;
+                }
+                visit(source);
+                while (not path.empty()) {
+                    auto v = path.back();
+                    if (cursor[v] < offset[v + 1]) {
+                        auto w = to[cursor[v]++];
+                        if (rindex[w] == 0) {
+                            visit(w);
+                        } else if (rindex[w] < rindex[v]) {
+                            rindex[v] = rindex[w];
+                            root[v] = false;
+                        }
+                        continue;
+                    }
+                    path.pop_back();
+                    if (root[v]) {
+                        --index;
+                        while (not stack.empty() and rindex[v] <= rindex[stack.back()]) {
+                            rindex[stack.back()] = label;
+                            stack.pop_back();
+                            --index;
+                        }
+                        rindex[v] = label--;
+                    } else {
+                        stack.push_back(v);
+                    }
+                    if (not path.empty() and rindex[v] < rindex[path.back()]) {
+                        rindex[path.back()] = rindex[v];
+                        root[path.back()] = false;
+                    }
+                }
+            }
+            for (auto &c : rindex) {
+                c = last - c;
+            }
+            return info{last - label, std::move(rindex)};
+        }
+
+        // 跨分量的边先按终点、再按起点做两趟计数排序, 每个分量的后继即有序, 相邻去重
+        [[nodiscard]] auto condensation(const info &scc) {
+            if (not frozen) {
+                freeze();
+            }
+            struct dag {
+                std::vector<std::uint32_t> offset;
+                std::vector<std::uint32_t> to;
+            };
+            const auto &component = scc.component;
+            std::vector<std::uint32_t> by_target(scc.count + 1), by_source(scc.count + 1);
+            for (std::uint32_t u = 0; u < n; ++u) {
+                for (auto e = offset[u]; e < offset[u + 1]; ++e) {
+                    if (auto a = component[u], b = component[to[e]]; a != b) {
+                        ++by_target[b + 1];
+                        ++by_source[a + 1];
+                    }
+                }
+            }
+            for (std::size_t c = 0; c < scc.count; ++c) {
+                by_target[c + 1] += by_target[c];
+                by_source[c + 1] += by_source[c];
+            }
+            std::vector<std::uint32_t> sources(by_target.back());
+            for (std::uint32_t u = 0; u < n; ++u) {
+                for (auto e = offset[u]; e < offset[u + 1]; ++e) {
+                    if (auto a = component[u], b = component[to[e]]; a != b) {
+                        sources[by_target[b]++] = a;
+                    }
+                }
+            }
+            dag res{std::vector<std::uint32_t>(scc.count + 1), std::vector<std::uint32_t>(sources.size())};
+            auto fill = by_source;
+            for (std::uint32_t b = 0, k = 0; b < scc.count; ++b) {
+                for (; k < by_target[b]; ++k) {
+                    auto a = sources[k];
+                    if (fill[a] == by_source[a] or res.to[fill[a] - 1] != b) {
+                        res.to[fill[a]++] = b;
+                    }
+                }
+            }
+            for (std::size_t c = 0, size = 0; c < scc.count; ++c) {
+                auto begin = by_source[c], end = fill[c];
+                std::copy(res.to.begin() + begin, res.to.begin() + end, res.to.begin() + size);
+                size += end - begin;
+                res.offset[c + 1] = size;
+            }
+            res.to.resize(res.offset.back());
+            return res;
+        }
+
+        // 点u的所有出边终点, 需先freeze()
+        std::span<const std::uint32_t> operator[](std::size_t u) const {
+            return {to.data() + offset[u], to.data() + offset[u + 1]};
+        }
+
+    private:
+        std::size_t n;
+        bool frozen;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+        std::vector<std::uint32_t> offset, to;
+    };
+
+    /* 2-SAT */
+    class TwoSat {
+    public:
+        TwoSat(std::size_t variable) : n(variable), graph(2 * variable) {}
+
+        std::size_t size() const {
+            return n;
+        }
+
+        // 子句(x_i == f) or (x_j == g)
+        void add_clause(std::size_t i, bool f, std::size_t j, bool g) {
+            graph.add_edge(2 * i + f, 2 * j + not g);
+            graph.add_edge(2 * j + g, 2 * i + not f);
+        }
+
+        [[nodiscard]] auto solve() {
+            struct info {
+                bool satisfiable;
+                std::vector<bool> answer;
+            };
+            auto [count, component] = graph.solve();
+            info res{true, std::vector<bool>(n)};
+            for (std::size_t i = 0; i < n; ++i) {
+                if (component[2 * i] == component[2 * i + 1]) {
+                    return info{false, {}};
+                }
+                res.answer[i] = component[2 * i] < component[2 * i + 1];
+            }
+            return res;
+        }
+
+    private:
+        std::size_t n;
+        Graph graph;
+    };
+}
\ No newline at end of file
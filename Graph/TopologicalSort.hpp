@@ -1,18 +1,28 @@
 /**
  * @brief 拓扑排序算法（Topological Sort）
  * @details 对有向无环图（DAG）进行拓扑排序，返回一个线性序列
- *          使用Kahn算法实现，基于入度的BFS方法
- * @complexity O(V + E), 其中V为顶点数，E为边数
+ *          使用Kahn算法实现，基于入度的BFS方法，输出数组本身即为队列
+ *          freeze()将邻接表转为32位下标的CSR数组，之后按CSR遍历；再次add_edge会回退到邻接表
+ *          levels()按轮输出Kahn的队列：同一层的点之间没有边，前面各层处理完后一层内的点可以并行处理
+ *          lexicographic()用小根堆代替队列，得到字典序最小的拓扑序；cycle()在有环时返回一个环作为证据
+ *          Online为在线维护的拓扑序（Pearce-Kelly）：插入的边与当前顺序矛盾时，只在两端点位置之间的区域内正向、反向搜索并重排受影响的点
+ *          会成环的边不插入，add_edge返回false并可由cycle()取得环
+ *          使用示例：TopologicalSort::Graph adj(n); adj.add_edge(u, v); adj.freeze(); auto [offset, order] = adj.levels();
+ *                    TopologicalSort::Online dag(n); if (not dag.add_edge(u, v)) { auto cycle = dag.cycle(); } dag.position(u);
+ * @complexity O(V + E), 其中V为顶点数，E为边数; 字典序最小: O(V log V + E); 在线插入: O(δ log δ), 其中δ为受影响区域内的点数与边数
  */
 #pragma once
-#include <queue>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
 namespace TopologicalSort {
     class Graph {
     public:
-        Graph(std::size_t vertex) : adj(vertex), _degree(vertex) {}
+        Graph(std::size_t vertex) : frozen(false), _degree(vertex), adj(vertex) {}
 
         void add_edge(std::size_t u, std::size_t v) {
+            frozen = false;
             adj[u].push_back(v);
             ++_degree[v];
         }
@@ -22,6 +32,7 @@ namespace TopologicalSort {
         }
 
         void resize(std::size_t vertex) {
+            frozen = false;
             adj.clear();
             _degree.clear();
             adj.resize(vertex);
@@ -36,27 +47,98 @@ namespace TopologicalSort {
             return _degree[index];
         }
 
+        void freeze() {
+            offset.assign(adj.size() + 1, 0);
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                offset[i + 1] = offset[i] + adj[i].size();
+            }
+            to.resize(offset.back());
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                std::copy(adj[i].begin(), adj[i].end(), to.begin() + offset[i]);
+            }
+            frozen = true;
+        }
+
         [[nodiscard]] std::vector<std::size_t> solve() const {
             std::vector<std::size_t> res;
-            std::vector<std::size_t> deg(_degree);
+            std::vector<std::uint32_t> deg(_degree.begin(), _degree.end());
+            res.reserve(adj.size());
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                if (deg[i] == 0) {
+                    res.push_back(i);
+                }
+            }
 
-            std::queue<std::size_t> Q;
+            for (std::size_t head = 0; head < res.size(); ++head) {
+                for_each_edge(res[head], [&](std::size_t v) {
+                    if (--deg[v] == 0) {
+                        res.push_back(v);
+                    }
+                });
+            }
+
+            if (res.size() != adj.size()) {
+                res.clear();
+            }
+            return res;
+        }
+
+        // 第l层为order[offset[l]]到order[offset[l + 1] - 1], 有环时两者均为空
+        [[nodiscard]] auto levels() const {
+            struct info {
+                std::vector<std::size_t> offset;
+                std::vector<std::size_t> order;
+            };
+            info res;
+            std::vector<std::uint32_t> deg(_degree.begin(), _degree.end());
+            res.order.reserve(adj.size());
             for (std::size_t i = 0; i < adj.size(); ++i) {
                 if (deg[i] == 0) {
-                    Q.push(i);
+                    res.order.push_back(i);
                 }
             }
 
-            while (not Q.empty()) {
-                auto u = Q.front();
-                Q.pop();
-                res.push_back(u);
+            res.offset.push_back(0);
+            for (std::size_t begin = 0, end; begin < res.order.size(); begin = end) {
+                end = res.order.size();
+                for (auto head = begin; head < end; ++head) {
+                    for_each_edge(res.order[head], [&](std::size_t v) {
+                        if (--deg[v] == 0) {
+                            res.order.push_back(v);
+                        }
+                    });
+                }
+                res.offset.push_back(end);
+            }
 
-                for (const auto &v : adj[u]) {
+            if (res.order.size() != adj.size()) {
+                res.offset.clear();
+                res.order.clear();
+            }
+            return res;
+        }
+
+        [[nodiscard]] std::vector<std::size_t> lexicographic() const {
+            std::vector<std::size_t> res, heap;
+            std::vector<std::uint32_t> deg(_degree.begin(), _degree.end());
+            res.reserve(adj.size());
+            for (std::size_t i = 0; i < adj.size(); ++i) {
+                if (deg[i] == 0) {
+                    heap.push_back(i);
+                }
+            }
+
+            while (not heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                auto u = heap.back();
+                heap.pop_back();
+                res.push_back(u);
+                for_each_edge(u, [&](std::size_t v) {
                     if (--deg[v] == 0) {
-                        Q.push(v);
+                        heap.push_back(v);
+                        std::push_heap(heap.begin(), heap.end(), std::greater<>());
                     }
-                }
+                });
             }
 
             if (res.size() != adj.size()) {
@@ -65,8 +147,215 @@ namespace TopologicalSort {
             return res;
         }
 
+        // 有环时返回环上的点c[0] -> c[1] -> ... -> c[k] -> c[0], 无环时返回空; 迭代DFS, 遇到栈中的点即找到环
+        [[nodiscard]] std::vector<std::size_t> cycle() const {
+            enum : std::uint8_t { white, gray, black };
+            std::vector<std::uint8_t> color(adj.size(), white);
+            std::vector<std::pair<std::size_t, std::size_t>> stack;
+            auto out_degree = [&](std::size_t u) -> std::size_t {
+                return frozen ? offset[u + 1] - offset[u] : adj[u].size();
+            };
+            auto neighbor = [&](std::size_t u, std::size_t k) -> std::size_t {
+                return frozen ? to[offset[u] + k] : adj[u][k];
+            };
+
+            for (std::size_t source = 0; source < adj.size(); ++source) {
+                if (color[source] != white) {
+                    continue;
+                }
+                color[source] = gray;
+                stack.emplace_back(source, 0);
+                while (not stack.empty()) {
+                    auto &[u, k] = stack.back();
+                    if (k == out_degree(u)) {
+                        color[u] = black;
+                        stack.pop_back();
+                        continue;
+                    }
+                    auto v = neighbor(u, k++);
+                    if (color[v] == white) {
+                        color[v] = gray;
+                        stack.emplace_back(v, 0);
+                    } else if (color[v] == gray) {
+                        std::vector<std::size_t> res;
+                        for (auto it = stack.rbegin(); it->first != v; ++it) {
+                            res.push_back(it->first);
+                        }
+                        res.push_back(v);
+                        std::reverse(res.begin(), res.end());
+                        return res;
+                    }
+                }
+            }
+            return {};
+        }
+
     private:
+        bool frozen;
+        std::vector<std::uint32_t> offset, to;
         std::vector<std::size_t> _degree;
         std::vector<std::vector<std::size_t>> adj;
+        void for_each_edge(std::size_t vertex, auto &&call) const {
+            if (frozen) {
+                for (std::size_t i = offset[vertex]; i != offset[vertex + 1]; ++i) {
+                    call(to[i]);
+                }
+            } else {
+                for (const auto &neighbor : adj[vertex]) {
+                    call(neighbor);
+                }
+            }
+        }
+    };
+
+    /* Pearce-Kelly 在线拓扑序 */
+    class Online {
+    public:
+        Online(std::size_t vertex) : out(vertex), in(vertex), _position(vertex), order(vertex), forward(vertex), backward(vertex), parent(vertex), epoch(0) {
+            for (std::uint32_t i = 0; i < vertex; ++i) {
+                _position[i] = order[i] = i;
+            }
+        }
+
+        std::size_t size() const {
+            return out.size();
+        }
+
+        // 新点排在当前拓扑序的末尾
+        std::size_t add_vertex() {
+            auto id = static_cast<std::uint32_t>(out.size());
+            out.emplace_back();
+            in.emplace_back();
+            _position.push_back(id);
+            order.push_back(id);
+            forward.push_back(0);
+            backward.push_back(0);
+            parent.push_back(0);
+            return id;
+        }
+
+        // 加边后仍无环时插入并返回true; 否则不插入, 返回false, 由cycle()给出v -> ... -> u -> v的环
+        bool add_edge(std::size_t u, std::size_t v) {
+            witness.clear();
+            if (u == v) {
+                witness.push_back(u);
+                return false;
+            }
+            if (_position[u] < _position[v]) {
+                out[u].push_back(v);
+                in[v].push_back(u);
+                return true;
+            }
+            auto lower = _position[v], upper = _position[u];
+            // 时间戳回绕时清空标记, 避免残留的旧标记与新时间戳相等
+            if (++epoch == 0) {
+                std::fill(forward.begin(), forward.end(), 0);
+                std::fill(backward.begin(), backward.end(), 0);
+                epoch = 1;
+            }
+            if (not search_forward(v, u, upper)) {
+                for (auto x = static_cast<std::uint32_t>(u); x != v; x = parent[x]) {
+                    witness.push_back(x);
+                }
+                witness.push_back(v);
+                std::reverse(witness.begin(), witness.end());
+                return false;
+            }
+            search_backward(u, lower);
+            reorder();
+            out[u].push_back(v);
+            in[v].push_back(u);
+            return true;
+        }
+
+        std::size_t position(std::size_t vertex) const {
+            return _position[vertex];
+        }
+
+        // 当前的拓扑序
+        [[nodiscard]] std::vector<std::size_t> solve() const {
+            return {order.begin(), order.end()};
+        }
+
+        const std::vector<std::size_t> &cycle() const {
+            return witness;
+        }
+
+        const std::vector<std::uint32_t> &operator[](std::size_t index) const {
+            return out[index];
+        }
+
+    private:
+        std::vector<std::vector<std::uint32_t>> out, in;
+        std::vector<std::uint32_t> _position, order, forward, backward, parent, stack, forward_set, backward_set, slots;
+        std::vector<std::size_t> witness;
+        std::uint32_t epoch;
+        // 从v出发只走位置不超过upper的点, 走到target说明成环
+        bool search_forward(std::uint32_t source, std::size_t target, std::uint32_t upper) {
+            forward_set.clear();
+            stack.assign(1, source);
+            forward[source] = epoch;
+            while (not stack.empty()) {
+                auto x = stack.back();
+                stack.pop_back();
+                forward_set.push_back(x);
+                for (auto y : out[x]) {
+                    if (y == target) {
+                        parent[y] = x;
+                        return false;
+                    }
+                    if (forward[y] != epoch and _position[y] < upper) {
+                        forward[y] = epoch;
+                        parent[y] = x;
+                        stack.push_back(y);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // 从u出发沿反向边只走位置大于lower的点
+        void search_backward(std::uint32_t source, std::uint32_t lower) {
+            backward_set.clear();
+            stack.assign(1, source);
+            backward[source] = epoch;
+            while (not stack.empty()) {
+                auto x = stack.back();
+                stack.pop_back();
+                backward_set.push_back(x);
+                for (auto y : in[x]) {
+                    if (backward[y] != epoch and lower < _position[y]) {
+                        backward[y] = epoch;
+                        stack.push_back(y);
+                    }
+                }
+            }
+        }
+
+        // 受影响的点占据的位置集合不变, 按原相对顺序先放能到达u的点, 再放从v可达的点
+        void reorder() {
+            auto by_position = [this](std::uint32_t x, std::uint32_t y) {
+                return _position[x] < _position[y];
+            };
+            std::sort(forward_set.begin(), forward_set.end(), by_position);
+            std::sort(backward_set.begin(), backward_set.end(), by_position);
+            slots.clear();
+            for (auto x : backward_set) {
+                slots.push_back(_position[x]);
+            }
+            for (auto x : forward_set) {
+                slots.push_back(_position[x]);
+            }
+            std::inplace_merge(slots.begin(), slots.begin() + backward_set.size(), slots.end());
+            std::size_t k = 0;
+            for (auto x : backward_set) {
+                _position[x] = slots[k];
+                order[slots[k++]] = x;
+            }
+            for (auto x : forward_set) {
+                _position[x] = slots[k];
+                order[slots[k++]] = x;
+            }
+        }
     };
 }
\ No newline at end of file